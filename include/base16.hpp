@@ -0,0 +1,179 @@
+#ifndef BASE16_HPP_
+#define BASE16_HPP_
+
+#include <array>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "base64.hpp"
+
+// Base16 (hex) encoding of RFC 4648, section 8, built on the output buffers
+// and iterator handling of base64.hpp.
+namespace base16 {
+
+// RFC 4648 uses upper case letters. Decoding accepts both cases.
+enum class alphabet { upper, lower };
+
+namespace detail {
+
+// Each entry holds both characters for a byte, so that encoding takes a single
+// table lookup per byte.
+template <alphabet A>
+constexpr std::array<std::array<char, 2>, 256> make_encode_table() {
+  constexpr std::string_view digits = A == alphabet::upper
+                                          ? "0123456789ABCDEF"
+                                          : "0123456789abcdef";
+  std::array<std::array<char, 2>, 256> table{};
+  for (size_t i = 0; i < 256; ++i) {
+    table[i] = {digits[i >> 4], digits[i & 0xF]};
+  }
+  return table;
+}
+
+// Values of the digits shifted by `Shift`, or `bad_digit` for characters that
+// are not hex digits.
+inline constexpr uint16_t bad_digit{0x100};
+
+template <int Shift>
+constexpr std::array<uint16_t, 256> make_decode_table() {
+  std::array<uint16_t, 256> table{};
+  for (size_t i = 0; i < 256; ++i) {
+    const char c = static_cast<char>(i);
+    uint16_t value = bad_digit;
+    if (c >= '0' && c <= '9') {
+      value = static_cast<uint16_t>((c - '0') << Shift);
+    } else if (c >= 'A' && c <= 'F') {
+      value = static_cast<uint16_t>((c - 'A' + 10) << Shift);
+    } else if (c >= 'a' && c <= 'f') {
+      value = static_cast<uint16_t>((c - 'a' + 10) << Shift);
+    }
+    table[i] = value;
+  }
+  return table;
+}
+
+template <alphabet A>
+inline constexpr std::array<std::array<char, 2>, 256> encode_table =
+    make_encode_table<A>();
+inline constexpr std::array<uint16_t, 256> decode_table_hi =
+    make_decode_table<4>();
+inline constexpr std::array<uint16_t, 256> decode_table_lo =
+    make_decode_table<0>();
+
+template <alphabet A>
+inline void encode(const uint8_t* bytes, size_t size,
+                   char* currEncoding) noexcept {
+  for (size_t i = 0; i < size; ++i) {
+    const std::array<char, 2>& digits = encode_table<A>[bytes[i]];
+    *currEncoding++ = digits[0];
+    *currEncoding++ = digits[1];
+  }
+}
+
+// Returns false if a character is not a hex digit. Invalid characters are
+// collected over the whole input to keep the loop free of branches.
+inline bool decode(const uint8_t* chars, size_t size,
+                   char* currDecoding) noexcept {
+  uint16_t invalid = 0;
+  for (size_t i = 0; i < size; i += 2) {
+    const uint16_t byte =
+        decode_table_hi[chars[i]] | decode_table_lo[chars[i + 1]];
+    invalid |= byte;
+    *currDecoding++ = static_cast<char>(byte);
+  }
+  return invalid < bad_digit;
+}
+
+template <class OutputBuffer, alphabet A, class InputIterator>
+inline OutputBuffer encode_into(InputIterator begin, InputIterator end) {
+  typedef std::decay_t<decltype(*begin)> input_value_type;
+  static_assert(base64::detail::is_byte_like_v<input_value_type>);
+  typedef typename OutputBuffer::value_type output_value_type;
+  static_assert(base64::detail::is_byte_like_v<output_value_type>);
+  const size_t binarytextsize = std::distance(begin, end);
+  base64::detail::call_probe probe(base64::operation::encode, binarytextsize);
+  if (binarytextsize == 0) {
+    probe.complete(0, base64::kernel::scalar);
+    return OutputBuffer();
+  }
+
+  OutputBuffer encoded = base64::output_buffer_traits<OutputBuffer>::create(
+      binarytextsize * 2, [&](char* currEncoding) {
+        if constexpr (base64::is_contiguous_iterator<InputIterator>::value) {
+          encode<A>(base64::detail::to_bytes(begin, end), binarytextsize,
+                    currEncoding);
+        } else {
+          base64::detail::for_each_gathered_block<1024>(
+              begin, binarytextsize, [&](const uint8_t* block, size_t count) {
+                encode<A>(block, count, currEncoding);
+                currEncoding += count * 2;
+              });
+        }
+      });
+  probe.complete(binarytextsize * 2, base64::kernel::scalar);
+  return encoded;
+}
+
+}  // namespace detail
+
+template <class OutputBuffer, alphabet A = alphabet::upper,
+          class InputIterator>
+inline OutputBuffer encode_into(InputIterator begin, InputIterator end) {
+  return detail::encode_into<OutputBuffer, A>(begin, end);
+}
+
+template <class OutputBuffer, alphabet A = alphabet::upper>
+inline OutputBuffer encode_into(std::string_view data) {
+  return detail::encode_into<OutputBuffer, A>(std::begin(data),
+                                              std::end(data));
+}
+
+inline std::string to_base16(std::string_view data) {
+  return encode_into<std::string>(data);
+}
+
+inline std::string to_base16_lower(std::string_view data) {
+  return encode_into<std::string, alphabet::lower>(data);
+}
+
+template <class OutputBuffer>
+inline OutputBuffer decode_into(std::string_view base16Text) {
+  typedef typename OutputBuffer::value_type output_value_type;
+  static_assert(base64::detail::is_byte_like_v<output_value_type>);
+  base64::detail::call_probe probe(base64::operation::decode,
+                                   base16Text.size());
+  if (base16Text.empty()) {
+    probe.complete(0, base64::kernel::scalar);
+    return OutputBuffer();
+  }
+  if ((base16Text.size() & 1) != 0) {
+    base64::detail::record_error(base64::decode_error::invalid_size);
+    throw std::runtime_error{"Invalid base16 encoded data - Invalid size"};
+  }
+
+  OutputBuffer decoded = base64::output_buffer_traits<OutputBuffer>::create(
+      base16Text.size() / 2, [&](char* currDecoding) {
+        if (!detail::decode(
+                reinterpret_cast<const uint8_t*>(base16Text.data()),
+                base16Text.size(), currDecoding)) {
+          base64::detail::record_error(
+              base64::decode_error::invalid_character);
+          throw std::runtime_error{
+              "Invalid base16 encoded data - Invalid character"};
+        }
+      });
+  probe.complete(base16Text.size() / 2, base64::kernel::scalar);
+  return decoded;
+}
+
+inline std::string from_base16(std::string_view data) {
+  return decode_into<std::string>(data);
+}
+
+}  // namespace base16
+
+#endif  // BASE16_HPP_
@@ -0,0 +1,237 @@
+#ifndef BASE32_HPP_
+#define BASE32_HPP_
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "base64.hpp"
+
+// Base32 encodings of RFC 4648, sections 6 and 7, built on the output buffers
+// and iterator handling of base64.hpp.
+namespace base32 {
+
+// `standard` uses A-Z and 2-7, `hex` uses 0-9 and A-V and keeps the sort
+// order of the data. Decoding accepts lower case letters and omitted padding.
+enum class alphabet { standard, hex };
+
+inline constexpr size_t encoded_size(size_t size) noexcept {
+  return (size + 4) / 5 * 8;
+}
+
+namespace detail {
+
+inline constexpr char padding_char{'='};
+
+// Value of a character, or `bad_char` for characters not in the alphabet.
+inline constexpr uint8_t bad_char{0x80};
+
+template <alphabet A>
+inline constexpr std::string_view digits =
+    A == alphabet::standard ? "ABCDEFGHIJKLMNOPQRSTUVWXYZ234567"
+                            : "0123456789ABCDEFGHIJKLMNOPQRSTUV";
+
+template <alphabet A>
+constexpr std::array<uint8_t, 256> make_decode_table() {
+  std::array<uint8_t, 256> table{};
+  for (uint8_t& value : table) {
+    value = bad_char;
+  }
+  for (size_t i = 0; i < 32; ++i) {
+    const char c = digits<A>[i];
+    table[static_cast<uint8_t>(c)] = static_cast<uint8_t>(i);
+    if (c >= 'A' && c <= 'Z') {
+      table[static_cast<uint8_t>(c - 'A' + 'a')] = static_cast<uint8_t>(i);
+    }
+  }
+  return table;
+}
+
+template <alphabet A>
+inline constexpr std::array<uint8_t, 256> decode_table =
+    make_decode_table<A>();
+
+// Number of characters that encode the `size` bytes of a final group, and
+// the reverse.
+inline constexpr size_t tail_chars(size_t size) noexcept {
+  return (size * 8 + 4) / 5;
+}
+inline constexpr size_t tail_bytes(size_t chars) noexcept {
+  return chars * 5 / 8;
+}
+
+template <alphabet A>
+inline void encode_group(const uint8_t* bytes, char* currEncoding) noexcept {
+  const uint64_t group = (uint64_t{bytes[0]} << 32) |
+                         (uint64_t{bytes[1]} << 24) |
+                         (uint64_t{bytes[2]} << 16) |
+                         (uint64_t{bytes[3]} << 8) | uint64_t{bytes[4]};
+  for (int i = 0; i < 8; ++i) {
+    currEncoding[i] = digits<A>[(group >> (35 - 5 * i)) & 0x1F];
+  }
+}
+
+// Encodes `size` bytes, padding the final group if `size` is not a multiple
+// of 5.
+template <alphabet A>
+inline void encode(const uint8_t* bytes, size_t size,
+                   char* currEncoding) noexcept {
+  for (; size >= 5; size -= 5, bytes += 5, currEncoding += 8) {
+    encode_group<A>(bytes, currEncoding);
+  }
+  if (size != 0) {
+    uint8_t last[5] = {};
+    std::copy(bytes, bytes + size, last);
+    encode_group<A>(last, currEncoding);
+    std::fill(currEncoding + tail_chars(size), currEncoding + 8,
+              padding_char);
+  }
+}
+
+// Decodes the groups of eight characters in `size` characters, the last of
+// which may be shorter. Returns false if a character is not in the
+// alphabet.
+template <alphabet A>
+inline bool decode(const uint8_t* chars, size_t size,
+                   char* currDecoding) noexcept {
+  uint8_t invalid = 0;
+  for (; size != 0; size -= std::min<size_t>(size, 8), chars += 8) {
+    const size_t count = std::min<size_t>(size, 8);
+    uint64_t group = 0;
+    for (size_t i = 0; i < 8; ++i) {
+      const uint8_t value = i < count ? decode_table<A>[chars[i]] : 0;
+      invalid |= value;
+      group = (group << 5) | value;
+    }
+    const size_t bytes = tail_bytes(count);
+    for (size_t i = 0; i < bytes; ++i) {
+      *currDecoding++ = static_cast<char>(group >> (32 - 8 * i));
+    }
+  }
+  return (invalid & bad_char) == 0;
+}
+
+// Returns the number of characters of `base32Text` without its padding, of
+// which there are at most six. Omitted padding is accepted.
+inline size_t unpadded_size(std::string_view base32Text) {
+  size_t size = base32Text.size();
+  if ((size & 7) == 0) {
+    while (size != 0 && base32Text.size() - size < 6 &&
+           base32Text[size - 1] == padding_char) {
+      --size;
+    }
+  }
+  switch (size & 7) {
+    case 1:
+    case 3:
+    case 6: {
+      base64::detail::record_error(base64::decode_error::invalid_size);
+      throw std::runtime_error{"Invalid base32 encoded data - Invalid size"};
+    }
+    default: {
+      break;
+    }
+  }
+  return size;
+}
+
+template <class OutputBuffer, alphabet A, class InputIterator>
+inline OutputBuffer encode_into(InputIterator begin, InputIterator end) {
+  typedef std::decay_t<decltype(*begin)> input_value_type;
+  static_assert(base64::detail::is_byte_like_v<input_value_type>);
+  typedef typename OutputBuffer::value_type output_value_type;
+  static_assert(base64::detail::is_byte_like_v<output_value_type>);
+  const size_t binarytextsize = std::distance(begin, end);
+  base64::detail::call_probe probe(base64::operation::encode, binarytextsize);
+  if (binarytextsize == 0) {
+    probe.complete(0, base64::kernel::scalar);
+    return OutputBuffer();
+  }
+
+  OutputBuffer encoded = base64::output_buffer_traits<OutputBuffer>::create(
+      encoded_size(binarytextsize), [&](char* currEncoding) {
+        if constexpr (base64::is_contiguous_iterator<InputIterator>::value) {
+          encode<A>(base64::detail::to_bytes(begin, end), binarytextsize,
+                    currEncoding);
+        } else {
+          base64::detail::for_each_gathered_block<1280>(
+              begin, binarytextsize, [&](const uint8_t* block, size_t count) {
+                encode<A>(block, count, currEncoding);
+                currEncoding += encoded_size(count);
+              });
+        }
+      });
+  probe.complete(encoded_size(binarytextsize), base64::kernel::scalar);
+  return encoded;
+}
+
+template <class OutputBuffer, alphabet A>
+inline OutputBuffer decode_into(std::string_view base32Text) {
+  typedef typename OutputBuffer::value_type output_value_type;
+  static_assert(base64::detail::is_byte_like_v<output_value_type>);
+  base64::detail::call_probe probe(base64::operation::decode,
+                                   base32Text.size());
+  const size_t size = unpadded_size(base32Text);
+  if (size == 0) {
+    probe.complete(0, base64::kernel::scalar);
+    return OutputBuffer();
+  }
+
+  const size_t decodedsize = size / 8 * 5 + tail_bytes(size & 7);
+  OutputBuffer decoded = base64::output_buffer_traits<OutputBuffer>::create(
+      decodedsize, [&](char* currDecoding) {
+        if (!decode<A>(reinterpret_cast<const uint8_t*>(base32Text.data()),
+                       size, currDecoding)) {
+          base64::detail::record_error(
+              base64::decode_error::invalid_character);
+          throw std::runtime_error{
+              "Invalid base32 encoded data - Invalid character"};
+        }
+      });
+  probe.complete(decodedsize, base64::kernel::scalar);
+  return decoded;
+}
+
+}  // namespace detail
+
+template <class OutputBuffer, alphabet A = alphabet::standard,
+          class InputIterator>
+inline OutputBuffer encode_into(InputIterator begin, InputIterator end) {
+  return detail::encode_into<OutputBuffer, A>(begin, end);
+}
+
+template <class OutputBuffer, alphabet A = alphabet::standard>
+inline OutputBuffer encode_into(std::string_view data) {
+  return detail::encode_into<OutputBuffer, A>(std::begin(data),
+                                              std::end(data));
+}
+
+inline std::string to_base32(std::string_view data) {
+  return encode_into<std::string>(data);
+}
+
+inline std::string to_base32hex(std::string_view data) {
+  return encode_into<std::string, alphabet::hex>(data);
+}
+
+template <class OutputBuffer, alphabet A = alphabet::standard>
+inline OutputBuffer decode_into(std::string_view base32Text) {
+  return detail::decode_into<OutputBuffer, A>(base32Text);
+}
+
+inline std::string from_base32(std::string_view data) {
+  return decode_into<std::string>(data);
+}
+
+inline std::string from_base32hex(std::string_view data) {
+  return decode_into<std::string, alphabet::hex>(data);
+}
+
+}  // namespace base32
+
+#endif  // BASE32_HPP_
@@ -6,19 +6,147 @@
 #include <cassert>
 #include <cstdint>
 #include <cstring>
+#include <exception>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
 #include <stdexcept>
 #include <string>
 #include <string_view>
 #include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "base64_decl.hpp"
 
 #if defined(__cpp_lib_bit_cast)
 #include <bit>  // For std::bit_cast.
 #endif
 
+#include <atomic>
+
+#if defined(BASE64_ENABLE_INSTRUMENTATION)
+#include <chrono>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>  // For non-temporal stores.
+#define BASE64_HAS_NON_TEMPORAL_STORES
+#endif
+
+#if defined(__GLIBC__)
+#include <unistd.h>  // For the size of the last-level cache.
+#endif
+
 namespace base64 {
 
+// The reasons for which decoding fails.
+enum class decode_error { invalid_size, invalid_padding, invalid_character };
+
+// The kernels that encode or decode, as reported by the instrumentation.
+// `scalar_non_temporal` writes large outputs with non-temporal stores.
+enum class kernel { scalar, scalar_non_temporal };
+inline constexpr size_t kernel_count{2};
+
+enum class operation { encode, decode };
+
+namespace instrumentation {
+
+// Per-thread counters of encode_into() and decode_into() calls. The arrays are
+// indexed by the enumerators of `operation`, `decode_error` and `kernel`.
+struct counters {
+  std::array<uint64_t, 2> calls{};
+  std::array<uint64_t, 2> bytes_in{};
+  std::array<uint64_t, 2> bytes_out{};
+  std::array<uint64_t, 3> errors{};
+  std::array<uint64_t, kernel_count> kernels{};
+};
+
+// Receives the duration of every encode_into() and decode_into() call, for
+// example to feed a latency histogram. Called on the calling thread.
+typedef void (*latency_hook)(operation op, size_t inputsize,
+                             uint64_t nanoseconds);
+
+#if defined(BASE64_ENABLE_INSTRUMENTATION)
+// Returns the counters of the calling thread.
+inline counters& thread_counters() noexcept {
+  thread_local counters threadCounters;
+  return threadCounters;
+}
+
+inline std::atomic<latency_hook>& latency_hook_slot() noexcept {
+  static std::atomic<latency_hook> hook{nullptr};
+  return hook;
+}
+
+// Installs `hook` for all threads. Pass nullptr to remove it.
+inline void set_latency_hook(latency_hook hook) noexcept {
+  latency_hook_slot().store(hook, std::memory_order_release);
+}
+#endif
+
+}  // namespace instrumentation
+
 namespace detail {
 
+#if defined(BASE64_ENABLE_INSTRUMENTATION)
+// Records an encode_into() or decode_into() call in the counters of the
+// calling thread and reports its latency to the hook, if one is installed.
+class call_probe {
+ public:
+  call_probe(operation op, size_t inputsize) noexcept
+      : op_(static_cast<size_t>(op)),
+        inputsize_(inputsize),
+        hook_(instrumentation::latency_hook_slot().load(
+            std::memory_order_acquire)) {
+    if (hook_ != nullptr) {
+      start_ = std::chrono::steady_clock::now();
+    }
+  }
+
+  call_probe(const call_probe&) = delete;
+  call_probe& operator=(const call_probe&) = delete;
+
+  ~call_probe() {
+    instrumentation::counters& counters = instrumentation::thread_counters();
+    ++counters.calls[op_];
+    counters.bytes_in[op_] += inputsize_;
+    if (hook_ != nullptr) {
+      const auto elapsed = std::chrono::steady_clock::now() - start_;
+      hook_(static_cast<operation>(op_), inputsize_,
+            static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)
+                    .count()));
+    }
+  }
+
+  void complete(size_t outputsize, kernel k) noexcept {
+    instrumentation::counters& counters = instrumentation::thread_counters();
+    counters.bytes_out[op_] += outputsize;
+    ++counters.kernels[static_cast<size_t>(k)];
+  }
+
+ private:
+  const size_t op_;
+  const size_t inputsize_;
+  const instrumentation::latency_hook hook_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+inline void record_error(decode_error error) noexcept {
+  ++instrumentation::thread_counters().errors[static_cast<size_t>(error)];
+}
+#else
+class call_probe {
+ public:
+  constexpr call_probe(operation, size_t) noexcept {}
+  constexpr void complete(size_t, kernel) const noexcept {}
+};
+
+inline constexpr void record_error(decode_error) noexcept {}
+#endif
+
 #if defined(__cpp_lib_bit_cast)
 using std::bit_cast;
 #else
@@ -499,134 +627,184 @@ std::array<char, 256> constexpr encode_table_1 = {
     '/'
 };
 
-}  // namespace detail
+// The base64url tables are derived from the standard ones by replacing the
+// entries for '+' and '/' with those for '-' and '_'.
+constexpr std::array<char, 256> make_url_encode_table(
+    const std::array<char, 256>& table) {
+  std::array<char, 256> result = table;
+  for (char& c : result) {
+    if (c == '+') {
+      c = '-';
+    } else if (c == '/') {
+      c = '_';
+    }
+  }
+  return result;
+}
 
-template <class OutputBuffer, class InputIterator>
-inline OutputBuffer encode_into(InputIterator begin, InputIterator end) {
-  typedef std::decay_t<decltype(*begin)> input_value_type;
-  static_assert(std::is_same_v<input_value_type, char> ||
-                std::is_same_v<input_value_type, signed char> ||
-                std::is_same_v<input_value_type, unsigned char> ||
-                std::is_same_v<input_value_type, std::byte>);
-  typedef typename OutputBuffer::value_type output_value_type;
-  static_assert(std::is_same_v<output_value_type, char> ||
-                std::is_same_v<output_value_type, signed char> ||
-                std::is_same_v<output_value_type, unsigned char> ||
-                std::is_same_v<output_value_type, std::byte>);
-  const size_t binarytextsize = end - begin;
-  const size_t encodedsize = (binarytextsize / 3 + (binarytextsize % 3 > 0))
-                             << 2;
-  OutputBuffer encoded(encodedsize, detail::padding_char);
-
-  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&*begin);
-  char* currEncoding = reinterpret_cast<char*>(&encoded[0]);
-
-  for (size_t i = binarytextsize / 3; i; --i) {
+constexpr std::array<std::uint32_t, 256> make_url_decode_table(
+    const std::array<std::uint32_t, 256>& table) {
+  std::array<std::uint32_t, 256> result = table;
+  result[static_cast<uint8_t>('-')] = table[static_cast<uint8_t>('+')];
+  result[static_cast<uint8_t>('_')] = table[static_cast<uint8_t>('/')];
+  result[static_cast<uint8_t>('+')] = bad_char;
+  result[static_cast<uint8_t>('/')] = bad_char;
+  return result;
+}
+
+std::array<char, 256> constexpr url_encode_table_0 =
+    make_url_encode_table(encode_table_0);
+std::array<char, 256> constexpr url_encode_table_1 =
+    make_url_encode_table(encode_table_1);
+std::array<std::uint32_t, 256> constexpr url_decode_table_0 =
+    make_url_decode_table(decode_table_0);
+std::array<std::uint32_t, 256> constexpr url_decode_table_1 =
+    make_url_decode_table(decode_table_1);
+std::array<std::uint32_t, 256> constexpr url_decode_table_2 =
+    make_url_decode_table(decode_table_2);
+std::array<std::uint32_t, 256> constexpr url_decode_table_3 =
+    make_url_decode_table(decode_table_3);
+
+template <alphabet A>
+struct tables {
+  static constexpr const std::array<char, 256>& encode_0 = encode_table_0;
+  static constexpr const std::array<char, 256>& encode_1 = encode_table_1;
+  static constexpr const std::array<std::uint32_t, 256>& decode_0 =
+      decode_table_0;
+  static constexpr const std::array<std::uint32_t, 256>& decode_1 =
+      decode_table_1;
+  static constexpr const std::array<std::uint32_t, 256>& decode_2 =
+      decode_table_2;
+  static constexpr const std::array<std::uint32_t, 256>& decode_3 =
+      decode_table_3;
+};
+
+template <>
+struct tables<alphabet::url> {
+  static constexpr const std::array<char, 256>& encode_0 = url_encode_table_0;
+  static constexpr const std::array<char, 256>& encode_1 = url_encode_table_1;
+  static constexpr const std::array<std::uint32_t, 256>& decode_0 =
+      url_decode_table_0;
+  static constexpr const std::array<std::uint32_t, 256>& decode_1 =
+      url_decode_table_1;
+  static constexpr const std::array<std::uint32_t, 256>& decode_2 =
+      url_decode_table_2;
+  static constexpr const std::array<std::uint32_t, 256>& decode_3 =
+      url_decode_table_3;
+};
+
+// Encodes `quanta` groups of three bytes into four characters each.
+template <alphabet A>
+inline void encode_quanta(const uint8_t* bytes, size_t quanta,
+                          char* currEncoding) noexcept {
+  for (size_t i = quanta; i; --i) {
     const uint8_t t1 = *bytes++;
     const uint8_t t2 = *bytes++;
     const uint8_t t3 = *bytes++;
-    *currEncoding++ = detail::encode_table_0[t1];
+    *currEncoding++ = tables<A>::encode_0[t1];
     *currEncoding++ =
-        detail::encode_table_1[((t1 & 0x03) << 4) | ((t2 >> 4) & 0x0F)];
+        tables<A>::encode_1[((t1 & 0x03) << 4) | ((t2 >> 4) & 0x0F)];
     *currEncoding++ =
-        detail::encode_table_1[((t2 & 0x0F) << 2) | ((t3 >> 6) & 0x03)];
-    *currEncoding++ = detail::encode_table_1[t3];
+        tables<A>::encode_1[((t2 & 0x0F) << 2) | ((t3 >> 6) & 0x03)];
+    *currEncoding++ = tables<A>::encode_1[t3];
   }
+}
 
-  switch (binarytextsize % 3) {
+// Encodes the final one or two bytes of the input, including the padding.
+template <alphabet A>
+inline void encode_tail(const uint8_t* bytes, size_t remaining,
+                        char* currEncoding) {
+  switch (remaining) {
     case 0: {
       break;
     }
     case 1: {
       const uint8_t t1 = bytes[0];
-      *currEncoding++ = detail::encode_table_0[t1];
-      *currEncoding++ = detail::encode_table_1[(t1 & 0x03) << 4];
+      *currEncoding++ = tables<A>::encode_0[t1];
+      *currEncoding++ = tables<A>::encode_1[(t1 & 0x03) << 4];
+      *currEncoding++ = padding_char;
+      *currEncoding++ = padding_char;
       break;
     }
     case 2: {
       const uint8_t t1 = bytes[0];
       const uint8_t t2 = bytes[1];
-      *currEncoding++ = detail::encode_table_0[t1];
+      *currEncoding++ = tables<A>::encode_0[t1];
       *currEncoding++ =
-          detail::encode_table_1[((t1 & 0x03) << 4) | ((t2 >> 4) & 0x0F)];
-      *currEncoding++ = detail::encode_table_1[(t2 & 0x0F) << 2];
+          tables<A>::encode_1[((t1 & 0x03) << 4) | ((t2 >> 4) & 0x0F)];
+      *currEncoding++ = tables<A>::encode_1[(t2 & 0x0F) << 2];
+      *currEncoding++ = padding_char;
       break;
     }
     default: {
       throw std::runtime_error{"Invalid base64 encoded data"};
     }
   }
-
-  return encoded;
 }
 
-template <class OutputBuffer>
-inline OutputBuffer encode_into(std::string_view data) {
-  return encode_into<OutputBuffer>(std::begin(data), std::end(data));
-}
-
-inline std::string to_base64(std::string_view data) {
-  return encode_into<std::string>(std::begin(data), std::end(data));
+// Encodes `size` bytes into `encoded_size(size)` characters.
+template <alphabet A>
+inline void encode(const uint8_t* bytes, size_t size, char* currEncoding) {
+  const size_t quanta = size / 3;
+  encode_quanta<A>(bytes, quanta, currEncoding);
+  encode_tail<A>(bytes + quanta * 3, size % 3, currEncoding + quanta * 4);
 }
 
-template <class OutputBuffer>
-inline OutputBuffer decode_into(std::string_view base64Text) {
-  typedef typename OutputBuffer::value_type output_value_type;
-  static_assert(std::is_same_v<output_value_type, char> ||
-                std::is_same_v<output_value_type, signed char> ||
-                std::is_same_v<output_value_type, unsigned char> ||
-                std::is_same_v<output_value_type, std::byte>);
-  if (base64Text.empty()) {
-    return OutputBuffer();
+// Same as encode() but processes the input from its end. This allows the
+// output to overlap the input as long as both start at the same address,
+// since every group is read before the (larger) encoded group is written.
+template <alphabet A>
+inline void encode_backward(const uint8_t* bytes, size_t size,
+                            char* currEncoding) {
+  size_t quanta = size / 3;
+  encode_tail<A>(bytes + quanta * 3, size % 3, currEncoding + quanta * 4);
+  while (quanta) {
+    --quanta;
+    encode_quanta<A>(bytes + quanta * 3, 1, currEncoding + quanta * 4);
   }
+}
 
-  if ((base64Text.size() & 3) != 0) {
-    throw std::runtime_error{
-        "Invalid base64 encoded data - Size not divisible by 4"};
-  }
-
-  const size_t numPadding =
-      std::count(base64Text.rbegin(), base64Text.rbegin() + 4, '=');
-  if (numPadding > 2) {
-    throw std::runtime_error{
-        "Invalid base64 encoded data - Found more than 2 padding signs"};
-  }
-
-  const size_t decodedsize = (base64Text.size() * 3 >> 2) - numPadding;
-  OutputBuffer decoded(decodedsize, '.');
-
-  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&base64Text[0]);
-  char* currDecoding = reinterpret_cast<char*>(&decoded[0]);
-
-  for (size_t i = (base64Text.size() >> 2) - (numPadding != 0); i; --i) {
+// Decodes `quanta` groups of four characters into three bytes each. Returns
+// false if an invalid character is found. The output may alias the input,
+// since every group is read before its bytes are written.
+template <alphabet A>
+inline bool decode_quanta(const uint8_t* bytes, size_t quanta,
+                          char* currDecoding) noexcept {
+  for (size_t i = quanta; i; --i) {
     const uint8_t t1 = *bytes++;
     const uint8_t t2 = *bytes++;
     const uint8_t t3 = *bytes++;
     const uint8_t t4 = *bytes++;
 
-    const uint32_t d1 = detail::decode_table_0[t1];
-    const uint32_t d2 = detail::decode_table_1[t2];
-    const uint32_t d3 = detail::decode_table_2[t3];
-    const uint32_t d4 = detail::decode_table_3[t4];
+    const uint32_t d1 = tables<A>::decode_0[t1];
+    const uint32_t d2 = tables<A>::decode_1[t2];
+    const uint32_t d3 = tables<A>::decode_2[t3];
+    const uint32_t d4 = tables<A>::decode_3[t4];
 
     const uint32_t temp = d1 | d2 | d3 | d4;
 
-    if (temp >= detail::bad_char) {
-      throw std::runtime_error{
-          "Invalid base64 encoded data - Invalid character"};
+    if (temp >= bad_char) {
+      return false;
     }
 
     // Use bit_cast instead of union and type punning to avoid
     // undefined behaviour risk:
     // https://en.wikipedia.org/wiki/Type_punning#Use_of_union
     const std::array<char, 4> tempBytes =
-        detail::bit_cast<std::array<char, 4>, uint32_t>(temp);
+        bit_cast<std::array<char, 4>, uint32_t>(temp);
 
-    *currDecoding++ = tempBytes[detail::decidx0];
-    *currDecoding++ = tempBytes[detail::decidx1];
-    *currDecoding++ = tempBytes[detail::decidx2];
+    *currDecoding++ = tempBytes[decidx0];
+    *currDecoding++ = tempBytes[decidx1];
+    *currDecoding++ = tempBytes[decidx2];
   }
+  return true;
+}
 
+// Decodes the final group, of which the last `numPadding` characters are
+// padding or omitted. Returns false if an invalid character is found.
+template <alphabet A>
+inline bool decode_tail(const uint8_t* bytes, size_t numPadding,
+                        char* currDecoding) {
   switch (numPadding) {
     case 0: {
       break;
@@ -636,69 +814,1178 @@ inline OutputBuffer decode_into(std::string_view base64Text) {
       const uint8_t t2 = *bytes++;
       const uint8_t t3 = *bytes++;
 
-      const uint32_t d1 = detail::decode_table_0[t1];
-      const uint32_t d2 = detail::decode_table_1[t2];
-      const uint32_t d3 = detail::decode_table_2[t3];
+      const uint32_t d1 = tables<A>::decode_0[t1];
+      const uint32_t d2 = tables<A>::decode_1[t2];
+      const uint32_t d3 = tables<A>::decode_2[t3];
 
       const uint32_t temp = d1 | d2 | d3;
 
-      if (temp >= detail::bad_char) {
-        throw std::runtime_error{
-            "Invalid base64 encoded data - Invalid character"};
+      if (temp >= bad_char) {
+        return false;
       }
 
       // Use bit_cast instead of union and type punning to avoid
       // undefined behaviour risk:
       // https://en.wikipedia.org/wiki/Type_punning#Use_of_union
       const std::array<char, 4> tempBytes =
-          detail::bit_cast<std::array<char, 4>, uint32_t>(temp);
-      *currDecoding++ = tempBytes[detail::decidx0];
-      *currDecoding++ = tempBytes[detail::decidx1];
+          bit_cast<std::array<char, 4>, uint32_t>(temp);
+      *currDecoding++ = tempBytes[decidx0];
+      *currDecoding++ = tempBytes[decidx1];
       break;
     }
     case 2: {
       const uint8_t t1 = *bytes++;
       const uint8_t t2 = *bytes++;
 
-      const uint32_t d1 = detail::decode_table_0[t1];
-      const uint32_t d2 = detail::decode_table_1[t2];
+      const uint32_t d1 = tables<A>::decode_0[t1];
+      const uint32_t d2 = tables<A>::decode_1[t2];
 
       const uint32_t temp = d1 | d2;
 
-      if (temp >= detail::bad_char) {
-        throw std::runtime_error{
-            "Invalid base64 encoded data - Invalid character"};
+      if (temp >= bad_char) {
+        return false;
       }
 
       const std::array<char, 4> tempBytes =
-          detail::bit_cast<std::array<char, 4>, uint32_t>(temp);
-      *currDecoding++ = tempBytes[detail::decidx0];
+          bit_cast<std::array<char, 4>, uint32_t>(temp);
+      *currDecoding++ = tempBytes[decidx0];
       break;
     }
     default: {
+      record_error(decode_error::invalid_padding);
       throw std::runtime_error{
           "Invalid base64 encoded data - Invalid padding number"};
     }
   }
+  return true;
+}
+
+inline constexpr size_t invalid_padding_count{static_cast<size_t>(-1)};
 
+// Validates the size and padding of `base64Text` and returns the number of
+// padding characters, including those implied by omitted padding. Returns
+// invalid_padding_count and stores the reason in `error` if they are invalid.
+template <alphabet A>
+inline size_t checked_padding(std::string_view base64Text,
+                              decode_error& error) noexcept {
+  const size_t remainder = base64Text.size() & 3;
+  if (A == alphabet::url && remainder > 1) {
+    return 4 - remainder;
+  }
+  if (remainder != 0) {
+    error = decode_error::invalid_size;
+    return invalid_padding_count;
+  }
+  if (base64Text.empty()) {
+    return 0;
+  }
+
+  // Unrolled count of the padding in the last group, without branches.
+  const char* last = base64Text.data() + base64Text.size() - 4;
+  const size_t numPadding =
+      static_cast<size_t>(last[0] == padding_char) +
+      static_cast<size_t>(last[1] == padding_char) +
+      static_cast<size_t>(last[2] == padding_char) +
+      static_cast<size_t>(last[3] == padding_char);
+  if (numPadding > 2) {
+    error = decode_error::invalid_padding;
+    return invalid_padding_count;
+  }
+  return numPadding;
+}
+
+// Same as checked_padding() but throws if the size or padding is invalid.
+template <alphabet A>
+inline size_t count_padding(std::string_view base64Text) {
+  decode_error error;
+  const size_t numPadding = checked_padding<A>(base64Text, error);
+  if (numPadding != invalid_padding_count) {
+    return numPadding;
+  }
+  record_error(error);
+  if (error == decode_error::invalid_padding) {
+    throw std::runtime_error{
+        "Invalid base64 encoded data - Found more than 2 padding signs"};
+  }
+  if constexpr (A == alphabet::url) {
+    throw std::runtime_error{"Invalid base64 encoded data - Invalid size"};
+  } else {
+    throw std::runtime_error{
+        "Invalid base64 encoded data - Size not divisible by 4"};
+  }
+}
+
+// Decodes `base64Text` whose padding was counted by count_padding(). The
+// output may alias the input.
+template <alphabet A>
+inline void decode(std::string_view base64Text, size_t numPadding,
+                   char* currDecoding) {
+  if (base64Text.empty()) {
+    return;
+  }
+
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(base64Text.data());
+  const size_t quanta = ((base64Text.size() + 3) >> 2) - (numPadding != 0);
+
+  if (!decode_quanta<A>(bytes, quanta, currDecoding) ||
+      !decode_tail<A>(bytes + quanta * 4, numPadding,
+                      currDecoding + quanta * 3)) {
+    record_error(decode_error::invalid_character);
+    throw std::runtime_error{"Invalid base64 encoded data - Invalid character"};
+  }
+}
+
+// Returns the decoded size of `size` characters with `numPadding` padding
+// characters as returned by count_padding().
+inline constexpr size_t decoded_size(size_t size, size_t numPadding) noexcept {
+  return ((size + 3) >> 2) * 3 - numPadding;
+}
+
+// Default for non_temporal_threshold() where the size of the last-level cache
+// cannot be determined.
+inline constexpr size_t default_last_level_cache_size{size_t{32} << 20};
+
+inline size_t last_level_cache_size() noexcept {
+#if defined(__GLIBC__) && defined(_SC_LEVEL3_CACHE_SIZE)
+  const int names[] = {_SC_LEVEL3_CACHE_SIZE, _SC_LEVEL2_CACHE_SIZE};
+  for (const int name : names) {
+    const long size = ::sysconf(name);
+    if (size > 0) {
+      return static_cast<size_t>(size);
+    }
+  }
+#endif
+  return default_last_level_cache_size;
+}
+
+inline std::atomic<size_t>& non_temporal_threshold_slot() noexcept {
+  static std::atomic<size_t> threshold{last_level_cache_size()};
+  return threshold;
+}
+
+#if defined(BASE64_HAS_NON_TEMPORAL_STORES)
+// Number of groups transcoded into an L1-resident staging buffer before it is
+// streamed to the output.
+inline constexpr size_t streaming_block_quanta{256};
+
+// How far ahead of the current block the input is prefetched.
+inline constexpr size_t streaming_prefetch_distance{4096};
+
+inline void prefetch_block(const uint8_t* bytes, size_t size) noexcept {
+  const char* next =
+      reinterpret_cast<const char*>(bytes) + streaming_prefetch_distance;
+  for (size_t i = 0; i < size; i += 64) {
+    _mm_prefetch(next + i, _MM_HINT_NTA);
+  }
+}
+
+// Copies `size` bytes with non-temporal stores, which write to memory without
+// first reading the destination cache lines or evicting other data. The
+// unaligned head and tail use regular stores.
+inline void stream_copy(char* dest, const char* src, size_t size) noexcept {
+  const size_t head = std::min<size_t>(
+      size, (16 - reinterpret_cast<uintptr_t>(dest) % 16) % 16);
+  std::memcpy(dest, src, head);
+  dest += head;
+  src += head;
+  size -= head;
+  for (; size >= 16; size -= 16, dest += 16, src += 16) {
+    _mm_stream_si128(reinterpret_cast<__m128i*>(dest),
+                     _mm_loadu_si128(reinterpret_cast<const __m128i*>(src)));
+  }
+  std::memcpy(dest, src, size);
+}
+
+template <alphabet A>
+inline void encode_non_temporal(const uint8_t* bytes, size_t size,
+                                char* currEncoding) noexcept {
+  alignas(64) char staging[streaming_block_quanta * 4];
+  for (size_t quanta = size / 3; quanta != 0;) {
+    const size_t count = std::min(quanta, streaming_block_quanta);
+    prefetch_block(bytes, count * 3);
+    encode_quanta<A>(bytes, count, staging);
+    stream_copy(currEncoding, staging, count * 4);
+    bytes += count * 3;
+    currEncoding += count * 4;
+    quanta -= count;
+  }
+  _mm_sfence();
+  encode_tail<A>(bytes, size % 3, currEncoding);
+}
+
+template <alphabet A>
+inline void decode_non_temporal(std::string_view base64Text,
+                                size_t numPadding, char* currDecoding) {
+  alignas(64) char staging[streaming_block_quanta * 3];
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(base64Text.data());
+  // The final block, which holds the padding, is decoded by decode().
+  size_t remaining = base64Text.size();
+  for (; remaining > streaming_block_quanta * 4 + 4;
+       remaining -= streaming_block_quanta * 4) {
+    prefetch_block(bytes, streaming_block_quanta * 4);
+    if (!decode_quanta<A>(bytes, streaming_block_quanta, staging)) {
+      _mm_sfence();
+      record_error(decode_error::invalid_character);
+      throw std::runtime_error{
+          "Invalid base64 encoded data - Invalid character"};
+    }
+    stream_copy(currDecoding, staging, streaming_block_quanta * 3);
+    bytes += streaming_block_quanta * 4;
+    currDecoding += streaming_block_quanta * 3;
+  }
+  _mm_sfence();
+  decode<A>(std::string_view(reinterpret_cast<const char*>(bytes), remaining),
+            numPadding, currDecoding);
+}
+#endif
+
+// Returns whether an output of `size` bytes is written with non-temporal
+// stores.
+inline bool use_non_temporal(size_t size) noexcept {
+#if defined(BASE64_HAS_NON_TEMPORAL_STORES)
+  return size >= non_temporal_threshold_slot().load(std::memory_order_relaxed);
+#else
+  static_cast<void>(size);
+  return false;
+#endif
+}
+
+template <class T>
+inline constexpr bool is_byte_like_v =
+    std::is_same_v<T, char> || std::is_same_v<T, signed char> ||
+    std::is_same_v<T, unsigned char> || std::is_same_v<T, std::byte>;
+
+template <class Iterator,
+          class T = typename std::iterator_traits<Iterator>::value_type>
+inline constexpr bool is_known_contiguous_v =
+#if defined(__cpp_lib_concepts)
+    std::contiguous_iterator<Iterator> ||
+#endif
+    std::is_pointer_v<Iterator> ||
+    std::is_same_v<Iterator, typename std::vector<T>::iterator> ||
+    std::is_same_v<Iterator, typename std::vector<T>::const_iterator> ||
+    std::is_same_v<Iterator, std::string::iterator> ||
+    std::is_same_v<Iterator, std::string::const_iterator> ||
+    std::is_same_v<Iterator, std::string_view::const_iterator>;
+
+}  // namespace detail
+
+// Tells whether `Iterator` points into contiguous memory that the kernels can
+// read directly. Other ranges, e.g. of a std::deque, are gathered into a small
+// buffer on the stack and encoded or decoded block by block. Specialize it for
+// contiguous iterators that are not detected automatically before C++20.
+template <class Iterator>
+struct is_contiguous_iterator
+    : std::bool_constant<detail::is_known_contiguous_v<Iterator>> {};
+
+// Returns the number of base64 characters needed to encode `size` bytes.
+inline constexpr size_t encoded_size(size_t size) noexcept {
+  return (size / 3 + (size % 3 > 0)) << 2;
+}
+
+// Outputs of at least this many bytes are written with non-temporal stores
+// where the CPU supports them (SSE2), so that encoding or decoding large data
+// does not evict the caches of other work. Defaults to the size of the
+// last-level cache.
+inline size_t non_temporal_threshold() noexcept {
+  return detail::non_temporal_threshold_slot().load(std::memory_order_relaxed);
+}
+
+// Sets non_temporal_threshold(). SIZE_MAX disables non-temporal stores.
+inline void set_non_temporal_threshold(size_t size) noexcept {
+  detail::non_temporal_threshold_slot().store(size, std::memory_order_relaxed);
+}
+
+namespace detail {
+
+// Number of characters of the encoding of `size` bytes without padding.
+inline constexpr size_t unpadded_size(size_t size) noexcept {
+  return (size * 4 + 2) / 3;
+}
+
+template <size_t N, alphabet A, size_t... I>
+inline void encode_fixed(const uint8_t* bytes, char* currEncoding,
+                         std::index_sequence<I...>) {
+  (encode_quanta<A>(bytes + I * 3, 1, currEncoding + I * 4), ...);
+  encode_tail<A>(bytes + N / 3 * 3, N % 3, currEncoding + N / 3 * 4);
+}
+
+template <size_t N, alphabet A, size_t... I>
+inline std::array<std::byte, N> decode_fixed(const char* base64Text,
+                                             size_t size,
+                                             std::index_sequence<I...>) {
+  constexpr size_t numPadding = (3 - N % 3) % 3;
+  if (size == encoded_size(N) && numPadding != 0 &&
+      (base64Text[size - 1] != padding_char ||
+       base64Text[size - numPadding] != padding_char)) {
+    record_error(decode_error::invalid_padding);
+    throw std::runtime_error{
+        "Invalid base64 encoded data - Invalid padding number"};
+  }
+
+  std::array<std::byte, N> decoded;
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(base64Text);
+  char* currDecoding = reinterpret_cast<char*>(decoded.data());
+  // Decode every group before checking the results so that the unrolled
+  // groups do not depend on each other.
+  const bool valid =
+      (true & ... & decode_quanta<A>(bytes + I * 4, 1, currDecoding + I * 3)) &
+      decode_tail<A>(bytes + N / 3 * 4, numPadding, currDecoding + N / 3 * 3);
+  if (!valid) {
+    record_error(decode_error::invalid_character);
+    throw std::runtime_error{"Invalid base64 encoded data - Invalid character"};
+  }
   return decoded;
 }
 
-template <class OutputBuffer, class InputIterator>
-inline OutputBuffer decode_into(InputIterator begin, InputIterator end) {
+template <size_t N, alphabet A>
+inline constexpr bool is_fixed_size(size_t size) noexcept {
+  return size == encoded_size(N) ||
+         (A == alphabet::url && size == unpadded_size(N));
+}
+
+}  // namespace detail
+
+// Encodes exactly N bytes, e.g. a key, digest or UUID, into a fixed-size array
+// without touching the heap. The groups are fully unrolled.
+template <size_t N, alphabet A = alphabet::standard, class T>
+inline std::array<char, encoded_size(N)> encode(const std::array<T, N>& data) {
+  static_assert(detail::is_byte_like_v<T>);
+  std::array<char, encoded_size(N)> encoded;
+  detail::encode_fixed<N, A>(reinterpret_cast<const uint8_t*>(data.data()),
+                             encoded.data(), std::make_index_sequence<N / 3>());
+  return encoded;
+}
+
+// Decodes the encoding of exactly N bytes. The size of the input is checked
+// at compile time.
+template <size_t N, alphabet A = alphabet::standard, class T, size_t M>
+inline std::array<std::byte, N> decode(const std::array<T, M>& base64Text) {
+  static_assert(detail::is_byte_like_v<T>);
+  static_assert(detail::is_fixed_size<N, A>(M),
+                "Input size does not match the encoding of N bytes");
+  return detail::decode_fixed<N, A>(
+      reinterpret_cast<const char*>(base64Text.data()), M,
+      std::make_index_sequence<N / 3>());
+}
+
+// Same as above for string literals.
+template <size_t N, alphabet A = alphabet::standard, size_t M>
+inline std::array<std::byte, N> decode(const char (&base64Text)[M]) {
+  static_assert(M > 0 && detail::is_fixed_size<N, A>(M - 1),
+                "Input size does not match the encoding of N bytes");
+  return detail::decode_fixed<N, A>(base64Text, M - 1,
+                                    std::make_index_sequence<N / 3>());
+}
+
+// Decodes the encoding of exactly N bytes. Throws if the input has a different
+// size.
+template <size_t N, alphabet A = alphabet::standard>
+inline std::array<std::byte, N> decode(std::string_view base64Text) {
+  if (!detail::is_fixed_size<N, A>(base64Text.size())) {
+    detail::record_error(decode_error::invalid_size);
+    throw std::runtime_error{"Invalid base64 encoded data - Unexpected size"};
+  }
+  return detail::decode_fixed<N, A>(base64Text.data(), base64Text.size(),
+                                    std::make_index_sequence<N / 3>());
+}
+
+// Customization point for the containers returned by encode_into() and
+// decode_into(). create() returns a container of `size` elements that
+// `writer(char*)` has filled, constructed with `alloc` if one was passed to
+// encode_into() or decode_into(). The default value-initializes the elements
+// before they are overwritten; specialize it for containers that can be
+// allocated uninitialized.
+template <class OutputBuffer>
+struct output_buffer_traits {
+  template <class Writer, class... Allocator>
+  static OutputBuffer create(size_t size, Writer&& writer,
+                             const Allocator&... alloc) {
+    typedef typename OutputBuffer::value_type value_type;
+    OutputBuffer buffer(size, value_type{}, alloc...);
+    if (size != 0) {
+      writer(reinterpret_cast<char*>(&buffer[0]));
+    }
+    return buffer;
+  }
+};
+
+#if defined(__cpp_lib_string_resize_and_overwrite)
+template <class CharT, class Traits, class Allocator>
+struct output_buffer_traits<std::basic_string<CharT, Traits, Allocator>> {
+  template <class Writer, class... Alloc>
+  static std::basic_string<CharT, Traits, Allocator> create(
+      size_t size, Writer&& writer, const Alloc&... alloc) {
+    std::basic_string<CharT, Traits, Allocator> buffer(alloc...);
+    // The operation of resize_and_overwrite() must not throw, so an exception
+    // of the writer is caught and rethrown once the string is valid again.
+    std::exception_ptr error;
+    buffer.resize_and_overwrite(size, [&](CharT* data, size_t n) {
+      try {
+        writer(reinterpret_cast<char*>(data));
+      } catch (...) {
+        error = std::current_exception();
+        return size_t{0};
+      }
+      return n;
+    });
+    if (error) {
+      std::rethrow_exception(error);
+    }
+    return buffer;
+  }
+};
+#endif
+
+namespace detail {
+
+// Size of the stack buffer that non-contiguous input is gathered into.
+inline constexpr size_t staging_quanta{256};
+
+template <class InputIterator>
+inline const uint8_t* to_bytes(InputIterator begin, InputIterator end) {
+  if (begin == end) {
+    return nullptr;
+  }
+  return reinterpret_cast<const uint8_t*>(std::addressof(*begin));
+}
+
+// Copies `size` bytes starting at `begin` into a stack buffer and calls
+// `fn(const uint8_t* block, size_t count)` for every `BlockSize` bytes. Only
+// the last block may be shorter.
+template <size_t BlockSize, class InputIterator, class Fn>
+inline void for_each_gathered_block(InputIterator begin, size_t size,
+                                    Fn&& fn) {
+  uint8_t staging[BlockSize];
+  while (size != 0) {
+    const size_t count = std::min(size, BlockSize);
+    for (size_t i = 0; i < count; ++i, ++begin) {
+      staging[i] = static_cast<uint8_t>(*begin);
+    }
+    fn(static_cast<const uint8_t*>(staging), count);
+    size -= count;
+  }
+}
+
+// Encodes `size` bytes starting at `begin` block by block from a stack buffer.
+template <alphabet A, class InputIterator>
+inline void encode_gathered(InputIterator begin, size_t size,
+                            char* currEncoding) {
+  for_each_gathered_block<staging_quanta * 3>(
+      begin, size, [&](const uint8_t* block, size_t count) {
+        encode<A>(block, count, currEncoding);
+        currEncoding += encoded_size(count);
+      });
+}
+
+// Decodes `size` characters starting at `begin` block by block from a stack
+// buffer. Every block holds whole groups, so the last one holds the padding.
+template <alphabet A, class InputIterator>
+inline void decode_gathered(InputIterator begin, size_t size,
+                            size_t numPadding, char* currDecoding) {
+  char staging[staging_quanta * 4];
+  while (size != 0) {
+    const size_t count = std::min(size, sizeof(staging));
+    for (size_t i = 0; i < count; ++i, ++begin) {
+      staging[i] = static_cast<char>(*begin);
+    }
+    size -= count;
+    if (size == 0) {
+      decode<A>(std::string_view(staging, count), numPadding, currDecoding);
+    } else if (!decode_quanta<A>(reinterpret_cast<const uint8_t*>(staging),
+                                 count / 4, currDecoding)) {
+      record_error(decode_error::invalid_character);
+      throw std::runtime_error{
+          "Invalid base64 encoded data - Invalid character"};
+    }
+    currDecoding += count / 4 * 3;
+  }
+}
+
+template <class OutputBuffer, alphabet A, class InputIterator,
+          class... Allocator>
+inline OutputBuffer encode_into(InputIterator begin, InputIterator end,
+                                const Allocator&... alloc) {
+  typedef std::decay_t<decltype(*begin)> input_value_type;
+  static_assert(is_byte_like_v<input_value_type>);
+  typedef typename OutputBuffer::value_type output_value_type;
+  static_assert(is_byte_like_v<output_value_type>);
+  const size_t binarytextsize = std::distance(begin, end);
+  call_probe probe(operation::encode, binarytextsize);
+  if (binarytextsize == 0) {
+    probe.complete(0, kernel::scalar);
+    return OutputBuffer(alloc...);
+  }
+
+  const size_t encodedsize = encoded_size(binarytextsize);
+  kernel used = kernel::scalar;
+  OutputBuffer encoded = output_buffer_traits<OutputBuffer>::create(
+      encodedsize,
+      [&](char* currEncoding) {
+        if constexpr (is_contiguous_iterator<InputIterator>::value) {
+#if defined(BASE64_HAS_NON_TEMPORAL_STORES)
+          if (use_non_temporal(encodedsize)) {
+            used = kernel::scalar_non_temporal;
+            encode_non_temporal<A>(to_bytes(begin, end), binarytextsize,
+                                   currEncoding);
+            return;
+          }
+#endif
+          encode<A>(to_bytes(begin, end), binarytextsize, currEncoding);
+        } else {
+          encode_gathered<A>(begin, binarytextsize, currEncoding);
+        }
+      },
+      alloc...);
+  probe.complete(encodedsize, used);
+  return encoded;
+}
+
+template <class OutputBuffer, alphabet A, class... Allocator>
+inline OutputBuffer decode_into(std::string_view base64Text,
+                                const Allocator&... alloc) {
+  typedef typename OutputBuffer::value_type output_value_type;
+  static_assert(is_byte_like_v<output_value_type>);
+  call_probe probe(operation::decode, base64Text.size());
+  if (base64Text.empty()) {
+    probe.complete(0, kernel::scalar);
+    return OutputBuffer(alloc...);
+  }
+
+  const size_t numPadding = count_padding<A>(base64Text);
+  const size_t decodedsize = decoded_size(base64Text.size(), numPadding);
+  kernel used = kernel::scalar;
+  OutputBuffer decoded = output_buffer_traits<OutputBuffer>::create(
+      decodedsize,
+      [&](char* currDecoding) {
+#if defined(BASE64_HAS_NON_TEMPORAL_STORES)
+        if (use_non_temporal(decodedsize)) {
+          used = kernel::scalar_non_temporal;
+          decode_non_temporal<A>(base64Text, numPadding, currDecoding);
+          return;
+        }
+#endif
+        decode<A>(base64Text, numPadding, currDecoding);
+      },
+      alloc...);
+  probe.complete(decodedsize, used);
+  return decoded;
+}
+
+template <class OutputBuffer, alphabet A, class InputIterator,
+          class... Allocator>
+inline OutputBuffer decode_into(InputIterator begin, InputIterator end,
+                                const Allocator&... alloc) {
   typedef std::decay_t<decltype(*begin)> input_value_type;
-  static_assert(std::is_same_v<input_value_type, char> ||
-                std::is_same_v<input_value_type, signed char> ||
-                std::is_same_v<input_value_type, unsigned char> ||
-                std::is_same_v<input_value_type, std::byte>);
-  std::string_view data(reinterpret_cast<const char*>(&*begin), end - begin);
-  return decode_into<OutputBuffer>(data);
+  static_assert(is_byte_like_v<input_value_type>);
+  if constexpr (is_contiguous_iterator<InputIterator>::value) {
+    return decode_into<OutputBuffer, A>(
+        std::string_view(reinterpret_cast<const char*>(to_bytes(begin, end)),
+                         end - begin),
+        alloc...);
+  } else {
+    typedef typename OutputBuffer::value_type output_value_type;
+    static_assert(is_byte_like_v<output_value_type>);
+    const size_t size = std::distance(begin, end);
+    call_probe probe(operation::decode, size);
+    if (size == 0) {
+      probe.complete(0, kernel::scalar);
+      return OutputBuffer(alloc...);
+    }
+
+    // The last (possibly partial) group decides the padding and has the same
+    // size modulo 4 as the whole input.
+    char lastGroup[4];
+    const size_t lastGroupSize = (size & 3) != 0 ? size & 3 : 4;
+    std::copy(std::next(begin, size - lastGroupSize), end, lastGroup);
+    const size_t numPadding =
+        count_padding<A>(std::string_view(lastGroup, lastGroupSize));
+
+    const size_t decodedsize = decoded_size(size, numPadding);
+    OutputBuffer decoded = output_buffer_traits<OutputBuffer>::create(
+        decodedsize,
+        [&](char* currDecoding) {
+          decode_gathered<A>(begin, size, numPadding, currDecoding);
+        },
+        alloc...);
+    probe.complete(decodedsize, kernel::scalar);
+    return decoded;
+  }
+}
+
+}  // namespace detail
+
+template <class OutputBuffer, alphabet A = alphabet::standard,
+          class InputIterator>
+inline OutputBuffer encode_into(InputIterator begin, InputIterator end) {
+  return detail::encode_into<OutputBuffer, A>(begin, end);
+}
+
+// Same as above, but the result is constructed with `alloc`. A pointer to a
+// std::pmr::memory_resource can be passed for std::pmr containers.
+template <class OutputBuffer, alphabet A = alphabet::standard,
+          class InputIterator>
+inline OutputBuffer encode_into(
+    InputIterator begin, InputIterator end,
+    const typename OutputBuffer::allocator_type& alloc) {
+  return detail::encode_into<OutputBuffer, A>(begin, end, alloc);
 }
 
-inline std::string from_base64(std::string_view data) {
-  return decode_into<std::string>(data);
+// Declared with its default arguments in base64_decl.hpp. Not inline, so that
+// base64_static can provide explicit instantiations.
+template <class OutputBuffer, alphabet A>
+OutputBuffer encode_into(std::string_view data) {
+  return detail::encode_into<OutputBuffer, A>(std::begin(data),
+                                              std::end(data));
 }
 
+template <class OutputBuffer, alphabet A = alphabet::standard>
+inline OutputBuffer encode_into(
+    std::string_view data, const typename OutputBuffer::allocator_type& alloc) {
+  return detail::encode_into<OutputBuffer, A>(std::begin(data), std::end(data),
+                                              alloc);
+}
+
+template <class OutputBuffer, alphabet A>
+OutputBuffer decode_into(std::string_view base64Text) {
+  return detail::decode_into<OutputBuffer, A>(base64Text);
+}
+
+template <class OutputBuffer, alphabet A = alphabet::standard>
+inline OutputBuffer decode_into(
+    std::string_view base64Text,
+    const typename OutputBuffer::allocator_type& alloc) {
+  return detail::decode_into<OutputBuffer, A>(base64Text, alloc);
+}
+
+template <class OutputBuffer, alphabet A = alphabet::standard,
+          class InputIterator>
+inline OutputBuffer decode_into(InputIterator begin, InputIterator end) {
+  return detail::decode_into<OutputBuffer, A>(begin, end);
+}
+
+template <class OutputBuffer, alphabet A = alphabet::standard,
+          class InputIterator>
+inline OutputBuffer decode_into(
+    InputIterator begin, InputIterator end,
+    const typename OutputBuffer::allocator_type& alloc) {
+  return detail::decode_into<OutputBuffer, A>(begin, end, alloc);
+}
+
+namespace detail {
+
+template <class Segment, class = void>
+struct is_iovec_like : std::false_type {};
+template <class Segment>
+struct is_iovec_like<Segment,
+                     std::void_t<decltype(std::declval<Segment>().iov_base),
+                                 decltype(std::declval<Segment>().iov_len)>>
+    : std::true_type {};
+
+template <class Segment>
+struct is_pointer_pair : std::false_type {};
+template <class T, class Size>
+struct is_pointer_pair<std::pair<T*, Size>> : std::true_type {};
+
+// Returns the bytes of a segment: anything with data() and size() such as
+// std::string_view or std::span, a struct iovec, or a (pointer, length) pair.
+template <class Segment>
+inline std::string_view segment_bytes(const Segment& segment) {
+  if constexpr (is_iovec_like<Segment>::value) {
+    return {static_cast<const char*>(segment.iov_base), segment.iov_len};
+  } else if constexpr (is_pointer_pair<Segment>::value) {
+    typedef std::remove_pointer_t<decltype(segment.first)> value_type;
+    static_assert(is_byte_like_v<std::remove_cv_t<value_type>>);
+    return {reinterpret_cast<const char*>(segment.first),
+            static_cast<size_t>(segment.second)};
+  } else {
+    typedef std::remove_cv_t<
+        std::remove_pointer_t<decltype(std::data(segment))>>
+        value_type;
+    static_assert(is_byte_like_v<value_type>);
+    return {reinterpret_cast<const char*>(std::data(segment)),
+            std::size(segment)};
+  }
+}
+
+// Encodes the concatenation of `segments` without copying it. Up to two bytes
+// at the end of a segment are carried over and completed from the next one,
+// so that every segment is otherwise encoded in place by the bulk kernel.
+template <class OutputBuffer, alphabet A, class Segments>
+inline OutputBuffer encode_segments_into(const Segments& segments) {
+  typedef typename OutputBuffer::value_type output_value_type;
+  static_assert(is_byte_like_v<output_value_type>);
+  size_t binarytextsize = 0;
+  for (const auto& segment : segments) {
+    binarytextsize += segment_bytes(segment).size();
+  }
+  call_probe probe(operation::encode, binarytextsize);
+
+  const size_t encodedsize = encoded_size(binarytextsize);
+  OutputBuffer encoded = output_buffer_traits<OutputBuffer>::create(
+      encodedsize, [&](char* currEncoding) {
+        uint8_t carry[3];
+        size_t carried = 0;
+        for (const auto& segment : segments) {
+          const std::string_view data = segment_bytes(segment);
+          const uint8_t* bytes =
+              reinterpret_cast<const uint8_t*>(data.data());
+          size_t size = data.size();
+          if (carried != 0) {
+            const size_t count = std::min(size, 3 - carried);
+            std::copy(bytes, bytes + count, carry + carried);
+            carried += count;
+            bytes += count;
+            size -= count;
+            if (carried < 3) {
+              continue;
+            }
+            encode_quanta<A>(carry, 1, currEncoding);
+            currEncoding += 4;
+            carried = 0;
+          }
+          const size_t quanta = size / 3;
+          encode_quanta<A>(bytes, quanta, currEncoding);
+          currEncoding += quanta * 4;
+          carried = size % 3;
+          std::copy(bytes + quanta * 3, bytes + size, carry);
+        }
+        encode_tail<A>(carry, carried, currEncoding);
+      });
+  probe.complete(encodedsize, kernel::scalar);
+  return encoded;
+}
+
+}  // namespace detail
+
+// Encodes a sequence of segments, e.g. the header, body chunks and trailer of
+// a response, as one base64 text. The result is the same as encoding their
+// concatenation.
+template <class OutputBuffer, alphabet A = alphabet::standard,
+          class Segments>
+inline OutputBuffer encode_segments_into(const Segments& segments) {
+  return detail::encode_segments_into<OutputBuffer, A>(segments);
+}
+
+template <class OutputBuffer, alphabet A = alphabet::standard>
+inline OutputBuffer encode_segments_into(
+    std::initializer_list<std::string_view> segments) {
+  return detail::encode_segments_into<OutputBuffer, A>(segments);
+}
+
+namespace detail {
+
+template <class Container>
+struct is_basic_string : std::false_type {};
+template <class CharT, class Traits, class Allocator>
+struct is_basic_string<std::basic_string<CharT, Traits, Allocator>>
+    : std::true_type {};
+
+// Grows `out` by `size` elements and lets `writer(char*)` fill them. If the
+// writer returns false, `out` is shrunk back to its previous contents and
+// false is returned. Strings are grown without filling the new elements
+// first when resize_and_overwrite (C++23) is available.
+template <class Container, class Writer>
+inline bool append_with(Container& out, size_t size, Writer&& writer) {
+  const size_t offset = out.size();
+  if (size == 0) {
+    return true;
+  }
+#if defined(__cpp_lib_string_resize_and_overwrite)
+  if constexpr (is_basic_string<Container>::value) {
+    bool written = false;
+    out.resize_and_overwrite(offset + size, [&](auto* data, size_t n) {
+      written = writer(reinterpret_cast<char*>(data) + offset);
+      return written ? n : offset;
+    });
+    return written;
+  } else
+#endif
+  {
+    out.resize(offset + size);
+    if (!writer(reinterpret_cast<char*>(&out[0]) + offset)) {
+      out.resize(offset);
+      return false;
+    }
+    return true;
+  }
+}
+
+}  // namespace detail
+
+// Appends the encoding of `data` to `out`, e.g. a std::string holding a
+// header or a JSON document being built. `out` is grown once by exactly
+// encoded_size(data.size()) and the encoding is written straight into it.
+template <alphabet A = alphabet::standard, class Container>
+inline void append_encoded(Container& out, std::string_view data) {
+  typedef typename Container::value_type output_value_type;
+  static_assert(detail::is_byte_like_v<output_value_type>);
+  detail::call_probe probe(operation::encode, data.size());
+  const size_t encodedsize = encoded_size(data.size());
+  detail::append_with(out, encodedsize, [&](char* currEncoding) {
+    detail::encode<A>(reinterpret_cast<const uint8_t*>(data.data()),
+                      data.size(), currEncoding);
+    return true;
+  });
+  probe.complete(encodedsize, kernel::scalar);
+}
+
+template <alphabet A = alphabet::standard, class Container, class Bytes,
+          std::enable_if_t<
+              !std::is_convertible_v<const Bytes&, std::string_view>, int> = 0>
+inline void append_encoded(Container& out, const Bytes& data) {
+  append_encoded<A>(out, detail::segment_bytes(data));
+}
+
+// Appends the decoding of `base64Text` to `out`, which is grown once by the
+// decoded size. If the text is invalid, std::runtime_error is thrown and the
+// contents of `out` are unchanged.
+template <alphabet A = alphabet::standard, class Container>
+inline void append_decoded(Container& out, std::string_view base64Text) {
+  typedef typename Container::value_type output_value_type;
+  static_assert(detail::is_byte_like_v<output_value_type>);
+  detail::call_probe probe(operation::decode, base64Text.size());
+  const size_t numPadding = detail::count_padding<A>(base64Text);
+  const size_t decodedsize =
+      detail::decoded_size(base64Text.size(), numPadding);
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(base64Text.data());
+  const size_t quanta = ((base64Text.size() + 3) >> 2) - (numPadding != 0);
+  if (!detail::append_with(out, decodedsize, [&](char* currDecoding) {
+        return detail::decode_quanta<A>(bytes, quanta, currDecoding) &&
+               detail::decode_tail<A>(bytes + quanta * 4, numPadding,
+                                      currDecoding + quanta * 3);
+      })) {
+    detail::record_error(decode_error::invalid_character);
+    throw std::runtime_error{"Invalid base64 encoded data - Invalid character"};
+  }
+  probe.complete(decodedsize, kernel::scalar);
+}
+
+namespace detail {
+
+template <alphabet A>
+inline constexpr char char_62 = A == alphabet::url ? '-' : '+';
+template <alphabet A>
+inline constexpr char char_63 = A == alphabet::url ? '_' : '/';
+
+// Maps `size` characters from alphabet `From` to `To`. Returns false if a
+// character is not in `From`. The loop has no table lookups or branches;
+// GCC 12 vectorizes it at -O3 but not at the -O2 of the default build.
+template <alphabet From, alphabet To>
+inline bool transcode_chars(const uint8_t* bytes, size_t size,
+                            char* currTranscoding) noexcept {
+  constexpr uint8_t shift62 = static_cast<uint8_t>(char_62<To> - char_62<From>);
+  constexpr uint8_t shift63 = static_cast<uint8_t>(char_63<To> - char_63<From>);
+  uint8_t invalid = 0;
+  for (size_t i = 0; i < size; ++i) {
+    const uint8_t c = bytes[i];
+    const uint8_t is62 = c == static_cast<uint8_t>(char_62<From>);
+    const uint8_t is63 = c == static_cast<uint8_t>(char_63<From>);
+    const uint8_t alnum = (static_cast<uint8_t>(c - 'A') < 26) |
+                          (static_cast<uint8_t>(c - 'a') < 26) |
+                          (static_cast<uint8_t>(c - '0') < 10);
+    invalid |= (alnum | is62 | is63) ^ 1;
+    currTranscoding[i] =
+        static_cast<char>(c + is62 * shift62 + is63 * shift63);
+  }
+  return invalid == 0;
+}
+
+}  // namespace detail
+
+// Converts base64 text from alphabet `From` to alphabet `To` without decoding
+// it, e.g. `transcode<alphabet::standard, alphabet::url>(text,
+// padding::unpadded)` for tokens. The input is validated against `From` like
+// decode_into() does, and the output is padded as requested.
+template <alphabet From, alphabet To, class OutputBuffer = std::string>
+inline OutputBuffer transcode(std::string_view base64Text,
+                              padding pad = padding::padded) {
+  typedef typename OutputBuffer::value_type output_value_type;
+  static_assert(detail::is_byte_like_v<output_value_type>);
+  detail::count_padding<From>(base64Text);
+  // npos + 1 is 0 if the text consists of padding only.
+  const size_t size = base64Text.find_last_not_of(detail::padding_char) + 1;
+  const size_t numPadding = base64Text.size() - size;
+  if (numPadding > 2 || (size & 3) == 1 ||
+      (numPadding != 0 && (base64Text.size() & 3) != 0)) {
+    detail::record_error(decode_error::invalid_padding);
+    throw std::runtime_error{"Invalid base64 encoded data - Invalid padding"};
+  }
+  const size_t outputsize =
+      pad == padding::padded ? (size + 3) / 4 * 4 : size;
+  return output_buffer_traits<OutputBuffer>::create(
+      outputsize, [&](char* currTranscoding) {
+        if (!detail::transcode_chars<From, To>(
+                reinterpret_cast<const uint8_t*>(base64Text.data()), size,
+                currTranscoding)) {
+          detail::record_error(decode_error::invalid_character);
+          throw std::runtime_error{
+              "Invalid base64 encoded data - Invalid character"};
+        }
+        std::fill(currTranscoding + size, currTranscoding + outputsize,
+                  detail::padding_char);
+      });
+}
+
+// Encodes the first `size` bytes of `data` in place and returns the encoded
+// size. `capacity` is the total number of bytes available at `data` and must
+// be at least encoded_size(size).
+template <alphabet A = alphabet::standard, class T>
+inline size_t encode_in_place(T* data, size_t size, size_t capacity) {
+  static_assert(detail::is_byte_like_v<T>);
+  const size_t encodedsize = encoded_size(size);
+  if (capacity < encodedsize) {
+    throw std::length_error{
+        "Insufficient capacity for in-place base64 encoding"};
+  }
+  detail::encode_backward<A>(reinterpret_cast<const uint8_t*>(data), size,
+                             reinterpret_cast<char*>(data));
+  return encodedsize;
+}
+
+// Encodes the contents of `buffer` in place, growing it to the encoded size.
+template <alphabet A = alphabet::standard, class Buffer>
+inline void encode_in_place(Buffer& buffer) {
+  typedef typename Buffer::value_type value_type;
+  static_assert(detail::is_byte_like_v<value_type>);
+  const size_t size = buffer.size();
+  buffer.resize(encoded_size(size));
+  if (size != 0) {
+    encode_in_place<A>(buffer.data(), size, buffer.size());
+  }
+}
+
+// Decodes `size` base64 characters at `data` in place and returns the decoded
+// size. The contents of `data` are unspecified if an exception is thrown.
+template <alphabet A = alphabet::standard, class T>
+inline size_t decode_in_place(T* data, size_t size) {
+  static_assert(detail::is_byte_like_v<T>);
+  const std::string_view base64Text(reinterpret_cast<const char*>(data), size);
+  const size_t numPadding = detail::count_padding<A>(base64Text);
+  detail::decode<A>(base64Text, numPadding, reinterpret_cast<char*>(data));
+  return detail::decoded_size(size, numPadding);
+}
+
+// Decodes the contents of `buffer` in place, shrinking it to the decoded size.
+// The contents of `buffer` are unspecified if an exception is thrown.
+template <alphabet A = alphabet::standard, class Buffer>
+inline void decode_in_place(Buffer& buffer) {
+  typedef typename Buffer::value_type value_type;
+  static_assert(detail::is_byte_like_v<value_type>);
+  buffer.resize(decode_in_place<A>(buffer.data(), buffer.size()));
+}
+
+namespace detail {
+
+// Number of groups decoded into the stack buffer at a time by equals().
+inline constexpr size_t equals_block_quanta{64};
+
+// Compares `size` decoded bytes with `expected`. With `ConstantTime`, the
+// differences are accumulated in `diff` instead of returning at the first.
+template <bool ConstantTime>
+inline bool compare_block(const char* decoded, const char* expected,
+                          size_t size, uint8_t& diff) noexcept {
+  if constexpr (ConstantTime) {
+    for (size_t i = 0; i < size; ++i) {
+      diff |= static_cast<uint8_t>(decoded[i] ^ expected[i]);
+    }
+    return true;
+  } else {
+    return std::memcmp(decoded, expected, size) == 0;
+  }
+}
+
+// Decodes `base64Text` block by block into a stack buffer and compares each
+// block with the corresponding bytes of `expected`.
+template <alphabet A, bool ConstantTime>
+inline bool equals(std::string_view base64Text, std::string_view expected) {
+  decode_error error;
+  const size_t numPadding = checked_padding<A>(base64Text, error);
+  if (numPadding == invalid_padding_count ||
+      decoded_size(base64Text.size(), numPadding) != expected.size()) {
+    return false;
+  }
+
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(base64Text.data());
+  const size_t quanta = ((base64Text.size() + 3) >> 2) - (numPadding != 0);
+  char decoded[equals_block_quanta * 3];
+  uint8_t diff = 0;
+  for (size_t done = 0; done < quanta;) {
+    const size_t count = std::min(equals_block_quanta, quanta - done);
+    if (!decode_quanta<A>(bytes + done * 4, count, decoded) ||
+        !compare_block<ConstantTime>(decoded, expected.data() + done * 3,
+                                     count * 3, diff)) {
+      return false;
+    }
+    done += count;
+  }
+  if (numPadding != 0 &&
+      (!decode_tail<A>(bytes + quanta * 4, numPadding, decoded) ||
+       !compare_block<ConstantTime>(decoded, expected.data() + quanta * 3,
+                                    3 - numPadding, diff))) {
+    return false;
+  }
+  return diff == 0;
+}
+
+}  // namespace detail
+
+// Returns whether `base64Text` decodes to `expected`, without allocating.
+// Malformed text compares unequal instead of throwing.
+template <alphabet A = alphabet::standard>
+inline bool equals(std::string_view base64Text, std::string_view expected) {
+  return detail::equals<A, false>(base64Text, expected);
+}
+
+template <alphabet A = alphabet::standard, class Bytes,
+          std::enable_if_t<
+              !std::is_convertible_v<const Bytes&, std::string_view>, int> = 0>
+inline bool equals(std::string_view base64Text, const Bytes& expected) {
+  return detail::equals<A, false>(base64Text,
+                                  detail::segment_bytes(expected));
+}
+
+// Same as equals(), but for secrets such as API keys and MACs: the time taken
+// does not depend on where the decoded bytes differ from `expected`. It does
+// depend on the sizes, and on the position of invalid characters.
+template <alphabet A = alphabet::standard>
+inline bool equals_constant_time(std::string_view base64Text,
+                                 std::string_view expected) {
+  return detail::equals<A, true>(base64Text, expected);
+}
+
+template <alphabet A = alphabet::standard, class Bytes,
+          std::enable_if_t<
+              !std::is_convertible_v<const Bytes&, std::string_view>, int> = 0>
+inline bool equals_constant_time(std::string_view base64Text,
+                                 const Bytes& expected) {
+  return detail::equals<A, true>(base64Text,
+                                 detail::segment_bytes(expected));
+}
+
+// When decoded_view checks the characters of its text: all of them when it
+// is constructed, or only those of the groups that are read.
+enum class validation { eager, lazy };
+
+// Read-only view of the bytes encoded by a base64 text, which is not decoded
+// as a whole. Every group of four characters encodes three bytes on its own,
+// so a read decodes only the groups that cover the requested bytes. The size
+// and padding of the text are always validated on construction.
+template <alphabet A = alphabet::standard>
+class basic_decoded_view {
+ public:
+  explicit basic_decoded_view(std::string_view base64Text,
+                              validation mode = validation::lazy)
+      : text_(base64Text),
+        numPadding_(detail::count_padding<A>(base64Text)),
+        size_(detail::decoded_size(base64Text.size(), numPadding_)) {
+    if (mode == validation::eager) {
+      validate();
+    }
+  }
+
+  size_t size() const noexcept { return size_; }
+  bool empty() const noexcept { return size_ == 0; }
+  std::string_view text() const noexcept { return text_; }
+
+  // Decodes up to `count` bytes starting at `offset` into `out` and returns
+  // the number of bytes written, which is less than `count` at the end of the
+  // data. Throws std::out_of_range if `offset` is past the end.
+  template <class T>
+  size_t read(size_t offset, size_t count, T* out) const {
+    static_assert(detail::is_byte_like_v<T>);
+    if (offset > size_) {
+      throw std::out_of_range{"base64::decoded_view::read - Invalid offset"};
+    }
+    count = std::min(count, size_ - offset);
+    char* currDecoding = reinterpret_cast<char*>(out);
+    size_t remaining = count;
+    char group[3];
+
+    // Bytes before the first whole group.
+    size_t quantum = offset / 3;
+    if (offset % 3 != 0 && remaining != 0) {
+      decode_group(quantum, group);
+      const size_t first = std::min(3 - offset % 3, remaining);
+      std::copy(group + offset % 3, group + offset % 3 + first, currDecoding);
+      currDecoding += first;
+      remaining -= first;
+      ++quantum;
+    }
+
+    // Whole groups are never the padded last group, so they are decoded in
+    // one pass straight into `out`.
+    const size_t quanta = remaining / 3;
+    if (!detail::decode_quanta<A>(
+            reinterpret_cast<const uint8_t*>(text_.data()) + quantum * 4,
+            quanta, currDecoding)) {
+      fail();
+    }
+    currDecoding += quanta * 3;
+    remaining -= quanta * 3;
+    quantum += quanta;
+
+    if (remaining != 0) {
+      decode_group(quantum, group);
+      std::copy(group, group + remaining, currDecoding);
+    }
+    return count;
+  }
+
+  // Decodes the byte at `index`, which must be less than size().
+  char operator[](size_t index) const {
+    assert(index < size_);
+    char byte;
+    read(index, 1, &byte);
+    return byte;
+  }
+
+  // Same as operator[], but throws std::out_of_range if `index` is not less
+  // than size().
+  char at(size_t index) const {
+    if (index >= size_) {
+      throw std::out_of_range{"base64::decoded_view::at - Invalid index"};
+    }
+    return (*this)[index];
+  }
+
+ private:
+  [[noreturn]] static void fail() {
+    detail::record_error(decode_error::invalid_character);
+    throw std::runtime_error{"Invalid base64 encoded data - Invalid character"};
+  }
+
+  // Decodes group `quantum`, which may be the padded last group, into `out`.
+  void decode_group(size_t quantum, char* out) const {
+    const uint8_t* bytes =
+        reinterpret_cast<const uint8_t*>(text_.data()) + quantum * 4;
+    const bool last = (quantum + 1) * 3 > size_;
+    if (!(last ? detail::decode_tail<A>(bytes, numPadding_, out)
+               : detail::decode_quanta<A>(bytes, 1, out))) {
+      fail();
+    }
+  }
+
+  // Checks every character except the padding in one branch-free pass.
+  void validate() const {
+    const size_t chars = detail::unpadded_size(size_);
+    uint32_t invalid = 0;
+    for (size_t i = 0; i < chars; ++i) {
+      invalid |= detail::tables<A>::decode_0[static_cast<uint8_t>(text_[i])];
+    }
+    if (invalid >= detail::bad_char) {
+      fail();
+    }
+  }
+
+  std::string_view text_;
+  size_t numPadding_;
+  size_t size_;
+};
+
+typedef basic_decoded_view<alphabet::standard> decoded_view;
+typedef basic_decoded_view<alphabet::url> decoded_url_view;
+
 }  // namespace base64
 
 #endif  // BASE64_HPP_
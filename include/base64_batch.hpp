@@ -0,0 +1,134 @@
+#ifndef BASE64_BATCH_HPP_
+#define BASE64_BATCH_HPP_
+
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "base64.hpp"
+
+namespace base64 {
+
+// Batches save the allocation and call overhead per message. Each message is
+// converted by the bulk kernel: a kernel interleaving the groups of several
+// messages was measured slower for 16 to 256 byte messages, as the groups of
+// one message are already independent and overlap in the CPU.
+
+// Outputs of encode_batch() or decode_batch(), stored back to back in one
+// buffer.
+template <class OutputBuffer = std::string>
+struct batch {
+  OutputBuffer data;
+  // Output i is data[offsets[i], offsets[i + 1]).
+  std::vector<size_t> offsets;
+  // Why decoding message i failed, if it did. The output of a failed message
+  // is empty when read with operator[].
+  std::vector<std::optional<decode_error>> errors;
+
+  size_t size() const noexcept { return errors.size(); }
+
+  std::string_view operator[](size_t index) const noexcept {
+    if (errors[index]) {
+      return {};
+    }
+    return {reinterpret_cast<const char*>(data.data()) + offsets[index],
+            offsets[index + 1] - offsets[index]};
+  }
+};
+
+// Encodes many independent messages, such as the fields of a telemetry
+// record, into one buffer. `messages` is a contiguous sequence (e.g. a
+// std::vector) of anything encode_segments_into() accepts as a segment.
+template <class OutputBuffer = std::string, alphabet A = alphabet::standard,
+          class Messages>
+inline batch<OutputBuffer> encode_batch(const Messages& messages) {
+  typedef typename OutputBuffer::value_type output_value_type;
+  static_assert(detail::is_byte_like_v<output_value_type>);
+  const auto* items = std::data(messages);
+  const size_t count = std::size(messages);
+
+  batch<OutputBuffer> result;
+  result.offsets.resize(count + 1);
+  result.errors.resize(count);
+  size_t inputsize = 0;
+  for (size_t i = 0; i < count; ++i) {
+    const size_t size = detail::segment_bytes(items[i]).size();
+    inputsize += size;
+    result.offsets[i + 1] = result.offsets[i] + encoded_size(size);
+  }
+
+  detail::call_probe probe(operation::encode, inputsize);
+  result.data = output_buffer_traits<OutputBuffer>::create(
+      result.offsets[count], [&](char* encoded) {
+        for (size_t i = 0; i < count; ++i) {
+          const std::string_view bytes = detail::segment_bytes(items[i]);
+          detail::encode<A>(reinterpret_cast<const uint8_t*>(bytes.data()),
+                            bytes.size(), encoded + result.offsets[i]);
+        }
+      });
+  probe.complete(result.offsets[count], kernel::scalar);
+  return result;
+}
+
+// Decodes many independent texts into one buffer. Invalid texts do not
+// throw; their error is reported in `errors` and the others are decoded.
+template <class OutputBuffer = std::string, alphabet A = alphabet::standard,
+          class Texts>
+inline batch<OutputBuffer> decode_batch(const Texts& texts) {
+  typedef typename OutputBuffer::value_type output_value_type;
+  static_assert(detail::is_byte_like_v<output_value_type>);
+  const auto* items = std::data(texts);
+  const size_t count = std::size(texts);
+
+  batch<OutputBuffer> result;
+  result.offsets.resize(count + 1);
+  result.errors.resize(count);
+  std::vector<uint8_t> paddings(count);
+  size_t inputsize = 0;
+  for (size_t i = 0; i < count; ++i) {
+    const std::string_view text = detail::segment_bytes(items[i]);
+    inputsize += text.size();
+    decode_error error;
+    const size_t numPadding = detail::checked_padding<A>(text, error);
+    size_t decodedsize = 0;
+    if (numPadding == detail::invalid_padding_count) {
+      result.errors[i] = error;
+      detail::record_error(error);
+    } else {
+      paddings[i] = static_cast<uint8_t>(numPadding);
+      decodedsize = detail::decoded_size(text.size(), numPadding);
+    }
+    result.offsets[i + 1] = result.offsets[i] + decodedsize;
+  }
+
+  detail::call_probe probe(operation::decode, inputsize);
+  result.data = output_buffer_traits<OutputBuffer>::create(
+      result.offsets[count], [&](char* decoded) {
+        for (size_t i = 0; i < count; ++i) {
+          const std::string_view text = detail::segment_bytes(items[i]);
+          if (result.errors[i] || text.empty()) {
+            continue;
+          }
+          const uint8_t* bytes =
+              reinterpret_cast<const uint8_t*>(text.data());
+          char* out = decoded + result.offsets[i];
+          const size_t quanta =
+              ((text.size() + 3) >> 2) - (paddings[i] != 0);
+          if (!detail::decode_quanta<A>(bytes, quanta, out) ||
+              !detail::decode_tail<A>(bytes + quanta * 4, paddings[i],
+                                      out + quanta * 3)) {
+            result.errors[i] = decode_error::invalid_character;
+            detail::record_error(decode_error::invalid_character);
+          }
+        }
+      });
+  probe.complete(result.offsets[count], kernel::scalar);
+  return result;
+}
+
+}  // namespace base64
+
+#endif  // BASE64_BATCH_HPP_
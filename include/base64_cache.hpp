@@ -0,0 +1,183 @@
+#ifndef BASE64_CACHE_HPP_
+#define BASE64_CACHE_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "base64.hpp"
+
+namespace base64 {
+
+struct decode_cache_options {
+  // Maximum number of cached texts, split over the shards. 0 disables the
+  // cache.
+  size_t capacity = 1024;
+  // Number of independently locked parts of the cache, at most `capacity`.
+  size_t shards = 16;
+  // Longer texts are decoded without being cached.
+  size_t max_text_size = 1024;
+};
+
+// Bounded, thread-safe cache of decoded texts for inputs that repeat, such as
+// JWT headers, tenant IDs and credentials. Texts are assigned to shards by
+// their hash. Lookups only take a shared lock on their shard, and entries are
+// evicted with the CLOCK algorithm, whose reference bits are atomic so that a
+// hit never needs an exclusive lock. Invalid texts throw like from_base64()
+// and are not cached.
+template <alphabet A = alphabet::standard>
+class basic_decode_cache {
+ public:
+  typedef std::shared_ptr<const std::string> value_type;
+
+  explicit basic_decode_cache(const decode_cache_options& options = {})
+      : shardcount_(std::clamp<size_t>(options.shards, 1,
+                                       std::max<size_t>(options.capacity, 1))),
+        capacity_(options.capacity),
+        maxtextsize_(options.max_text_size),
+        shards_(new shard[shardcount_]) {
+    // The first shards hold one more text each if the capacity is not a
+    // multiple of their number.
+    for (size_t i = 0; i < shardcount_; ++i) {
+      shard& s = shards_[i];
+      s.capacity = capacity_ / shardcount_ + (i < capacity_ % shardcount_);
+      s.slots.reset(new slot[s.capacity]);
+    }
+  }
+
+  basic_decode_cache(const basic_decode_cache&) = delete;
+  basic_decode_cache& operator=(const basic_decode_cache&) = delete;
+
+  // Returns the decoding of `base64Text`, shared with other callers that
+  // decode the same text.
+  value_type decode(std::string_view base64Text) {
+    if (capacity_ == 0 || base64Text.size() > maxtextsize_) {
+      return std::make_shared<const std::string>(
+          decode_into<std::string, A>(base64Text));
+    }
+    shard& s =
+        shards_[std::hash<std::string_view>()(base64Text) % shardcount_];
+    {
+      std::shared_lock<std::shared_mutex> lock(s.mutex);
+      const auto it = s.index.find(base64Text);
+      if (it != s.index.end()) {
+        slot& entry = s.slots[it->second];
+        entry.referenced.store(true, std::memory_order_relaxed);
+        s.hits.fetch_add(1, std::memory_order_relaxed);
+        return entry.value;
+      }
+    }
+
+    s.misses.fetch_add(1, std::memory_order_relaxed);
+    value_type value = std::make_shared<const std::string>(
+        decode_into<std::string, A>(base64Text));
+    std::unique_lock<std::shared_mutex> lock(s.mutex);
+    const auto it = s.index.find(base64Text);
+    if (it != s.index.end()) {
+      return s.slots[it->second].value;
+    }
+    const size_t index = s.evict();
+    slot& entry = s.slots[index];
+    entry.key.assign(base64Text.data(), base64Text.size());
+    entry.value = value;
+    entry.referenced.store(false, std::memory_order_relaxed);
+    s.index.emplace(std::string_view(entry.key), index);
+    return value;
+  }
+
+  // Number of decode() calls answered from the cache, and of those that had
+  // to decode a text that can be cached.
+  uint64_t hits() const noexcept { return sum(&shard::hits); }
+  uint64_t misses() const noexcept { return sum(&shard::misses); }
+
+  // Maximum number of cached texts.
+  size_t capacity() const noexcept { return capacity_; }
+
+  // Number of cached texts.
+  size_t size() const {
+    size_t total = 0;
+    for (size_t i = 0; i < shardcount_; ++i) {
+      std::shared_lock<std::shared_mutex> lock(shards_[i].mutex);
+      total += shards_[i].index.size();
+    }
+    return total;
+  }
+
+  // Removes all texts. Buffers returned earlier stay valid.
+  void clear() {
+    for (size_t i = 0; i < shardcount_; ++i) {
+      shard& s = shards_[i];
+      std::unique_lock<std::shared_mutex> lock(s.mutex);
+      s.index.clear();
+      for (size_t j = 0; j < s.used; ++j) {
+        s.slots[j].key.clear();
+        s.slots[j].value.reset();
+      }
+      s.used = 0;
+      s.hand = 0;
+    }
+  }
+
+ private:
+  struct slot {
+    std::string key;
+    value_type value;
+    std::atomic<bool> referenced{false};
+  };
+
+  // Aligned so that the counters of different shards do not share a cache
+  // line.
+  struct alignas(64) shard {
+    // Returns a free slot, evicting the first entry since the hand whose
+    // reference bit is clear, and clearing the bits it passes.
+    size_t evict() {
+      if (used < capacity) {
+        return used++;
+      }
+      while (slots[hand].referenced.exchange(false,
+                                             std::memory_order_relaxed)) {
+        hand = (hand + 1) % capacity;
+      }
+      const size_t victim = hand;
+      hand = (hand + 1) % capacity;
+      index.erase(std::string_view(slots[victim].key));
+      return victim;
+    }
+
+    mutable std::shared_mutex mutex;
+    std::unordered_map<std::string_view, size_t> index;
+    std::unique_ptr<slot[]> slots;
+    size_t capacity = 0;
+    size_t used = 0;
+    size_t hand = 0;
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> misses{0};
+  };
+
+  uint64_t sum(std::atomic<uint64_t> shard::*counter) const noexcept {
+    uint64_t total = 0;
+    for (size_t i = 0; i < shardcount_; ++i) {
+      total += (shards_[i].*counter).load(std::memory_order_relaxed);
+    }
+    return total;
+  }
+
+  const size_t shardcount_;
+  const size_t capacity_;
+  const size_t maxtextsize_;
+  std::unique_ptr<shard[]> shards_;
+};
+
+typedef basic_decode_cache<alphabet::standard> decode_cache;
+typedef basic_decode_cache<alphabet::url> decode_url_cache;
+
+}  // namespace base64
+
+#endif  // BASE64_CACHE_HPP_
@@ -0,0 +1,247 @@
+#ifndef BASE64_CHAIN_HPP_
+#define BASE64_CHAIN_HPP_
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "base64.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/uio.h>  // For struct iovec.
+#define BASE64_HAS_IOVEC
+#endif
+
+namespace base64 {
+
+inline constexpr size_t default_chunk_size{size_t{1} << 20};
+
+// Output made of a chain of fixed-size blocks, for results too large to be
+// allocated contiguously. The blocks are allocated one at a time with
+// `Allocator`, e.g. a std::pmr::polymorphic_allocator<char> over a pool, and
+// each is filled completely before the next is started, so only the last
+// block is partially used.
+template <class Allocator = std::allocator<char>>
+class basic_chunk_chain {
+ public:
+  typedef Allocator allocator_type;
+  static_assert(std::is_same_v<typename Allocator::value_type, char>);
+
+  explicit basic_chunk_chain(size_t blockSize = default_chunk_size,
+                             const Allocator& alloc = Allocator())
+      : alloc_(alloc), blocksize_(std::max<size_t>(blockSize, 1)) {}
+
+  basic_chunk_chain(const basic_chunk_chain&) = delete;
+  basic_chunk_chain& operator=(const basic_chunk_chain&) = delete;
+
+  basic_chunk_chain(basic_chunk_chain&& other) noexcept
+      : alloc_(other.alloc_),
+        blocksize_(other.blocksize_),
+        blocks_(std::move(other.blocks_)),
+        size_(std::exchange(other.size_, 0)) {
+    other.blocks_.clear();
+  }
+
+  // Takes over the blocks of `other` if they can be freed with this chain's
+  // allocator, and copies them otherwise.
+  basic_chunk_chain& operator=(basic_chunk_chain&& other) {
+    if (this == &other) {
+      return *this;
+    }
+    clear();
+    if constexpr (std::allocator_traits<Allocator>::
+                      propagate_on_container_move_assignment::value) {
+      alloc_ = other.alloc_;
+    } else if (!(alloc_ == other.alloc_)) {
+      for (size_t i = 0; i < other.block_count(); ++i) {
+        const std::string_view data = other.block(i);
+        append(data.data(), data.size());
+      }
+      other.clear();
+      return *this;
+    }
+    blocksize_ = other.blocksize_;
+    blocks_ = std::move(other.blocks_);
+    size_ = std::exchange(other.size_, 0);
+    other.blocks_.clear();
+    return *this;
+  }
+
+  ~basic_chunk_chain() { clear(); }
+
+  // Frees all blocks.
+  void clear() noexcept {
+    for (char* block : blocks_) {
+      std::allocator_traits<Allocator>::deallocate(alloc_, block, blocksize_);
+    }
+    blocks_.clear();
+    size_ = 0;
+  }
+
+  size_t size() const noexcept { return size_; }
+  bool empty() const noexcept { return size_ == 0; }
+  size_t block_size() const noexcept { return blocksize_; }
+  size_t block_count() const noexcept { return blocks_.size(); }
+
+  // The used part of block `index`.
+  std::string_view block(size_t index) const noexcept {
+    const size_t used = index + 1 < blocks_.size()
+                            ? blocksize_
+                            : size_ - index * blocksize_;
+    return {blocks_[index], used};
+  }
+
+  // Copies the contents into one string.
+  std::string str() const {
+    std::string result;
+    result.reserve(size_);
+    for (size_t i = 0; i < blocks_.size(); ++i) {
+      result += block(i);
+    }
+    return result;
+  }
+
+#if defined(BASE64_HAS_IOVEC)
+  // The used parts of the blocks, for writev(). A single writev() call
+  // accepts at most IOV_MAX of them.
+  std::vector<iovec> iovecs() const {
+    std::vector<iovec> result(blocks_.size());
+    for (size_t i = 0; i < blocks_.size(); ++i) {
+      const std::string_view data = block(i);
+      result[i].iov_base = const_cast<char*>(data.data());
+      result[i].iov_len = data.size();
+    }
+    return result;
+  }
+#endif
+
+  // Returns the free space at the end of the last block, starting a new block
+  // if it is full, and stores its size in `available`. The space becomes part
+  // of the contents with commit().
+  char* append_space(size_t& available) {
+    if (size_ == blocks_.size() * blocksize_) {
+      blocks_.reserve(blocks_.size() + 1);
+      blocks_.push_back(
+          std::allocator_traits<Allocator>::allocate(alloc_, blocksize_));
+    }
+    const size_t used = size_ - (blocks_.size() - 1) * blocksize_;
+    available = blocksize_ - used;
+    return blocks_.back() + used;
+  }
+
+  void commit(size_t size) noexcept { size_ += size; }
+
+  void append(const char* data, size_t size) {
+    while (size != 0) {
+      size_t available;
+      char* space = append_space(available);
+      const size_t count = std::min(size, available);
+      std::copy(data, data + count, space);
+      commit(count);
+      data += count;
+      size -= count;
+    }
+  }
+
+ private:
+  Allocator alloc_;
+  size_t blocksize_;
+  std::vector<char*> blocks_;
+  size_t size_ = 0;
+};
+
+typedef basic_chunk_chain<> chunk_chain;
+
+namespace detail {
+
+// Converts `quanta` groups of `In` bytes at `bytes` into groups of `Out`
+// bytes at the end of `chain` with `kernel(bytes, n, out)`, which returns
+// false for invalid input. The kernel writes straight into the blocks; only a
+// group that spans two blocks goes through a temporary buffer.
+template <size_t In, size_t Out, class Chain, class Kernel>
+inline bool fill_chain(Chain& chain, const uint8_t* bytes, size_t quanta,
+                       Kernel&& kernel) {
+  while (quanta != 0) {
+    size_t available;
+    char* space = chain.append_space(available);
+    size_t count = std::min(quanta, available / Out);
+    if (count != 0) {
+      if (!kernel(bytes, count, space)) {
+        return false;
+      }
+      chain.commit(count * Out);
+    } else {
+      char group[Out];
+      count = 1;
+      if (!kernel(bytes, count, group)) {
+        return false;
+      }
+      chain.append(group, Out);
+    }
+    bytes += count * In;
+    quanta -= count;
+  }
+  return true;
+}
+
+}  // namespace detail
+
+// Appends the base64 encoding of `binaryText` to `chain`.
+template <alphabet A = alphabet::standard, class Allocator>
+inline void encode_into_chain(std::string_view binaryText,
+                              basic_chunk_chain<Allocator>& chain) {
+  detail::call_probe probe(operation::encode, binaryText.size());
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(binaryText.data());
+  const size_t quanta = binaryText.size() / 3;
+  detail::fill_chain<3, 4>(chain, bytes, quanta,
+                           [](const uint8_t* in, size_t n, char* out) {
+                             detail::encode_quanta<A>(in, n, out);
+                             return true;
+                           });
+
+  const size_t remaining = binaryText.size() % 3;
+  if (remaining != 0) {
+    char tail[4];
+    detail::encode_tail<A>(bytes + quanta * 3, remaining, tail);
+    chain.append(tail, sizeof(tail));
+  }
+  probe.complete(encoded_size(binaryText.size()), kernel::scalar);
+}
+
+// Appends the decoding of `base64Text` to `chain`. If an exception is thrown,
+// part of the decoded data may have been appended.
+template <alphabet A = alphabet::standard, class Allocator>
+inline void decode_into_chain(std::string_view base64Text,
+                              basic_chunk_chain<Allocator>& chain) {
+  detail::call_probe probe(operation::decode, base64Text.size());
+  const size_t numPadding = detail::count_padding<A>(base64Text);
+  if (base64Text.empty()) {
+    probe.complete(0, kernel::scalar);
+    return;
+  }
+
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(base64Text.data());
+  const size_t quanta = ((base64Text.size() + 3) >> 2) - (numPadding != 0);
+  char tail[3];
+  if (!detail::fill_chain<4, 3>(chain, bytes, quanta,
+                                detail::decode_quanta<A>) ||
+      !detail::decode_tail<A>(bytes + quanta * 4, numPadding, tail)) {
+    detail::record_error(decode_error::invalid_character);
+    throw std::runtime_error{"Invalid base64 encoded data - Invalid character"};
+  }
+  if (numPadding != 0) {
+    chain.append(tail, 3 - numPadding);
+  }
+  probe.complete(detail::decoded_size(base64Text.size(), numPadding),
+                 kernel::scalar);
+}
+
+}  // namespace base64
+
+#endif  // BASE64_CHAIN_HPP_
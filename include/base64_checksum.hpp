@@ -0,0 +1,320 @@
+#ifndef BASE64_CHECKSUM_HPP_
+#define BASE64_CHECKSUM_HPP_
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+
+#include "base64.hpp"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <nmmintrin.h>
+#define BASE64_CRC32C_X86
+// __crc32cd() takes the bytes in little-endian order, so big-endian AArch64
+// uses the portable slicing-by-8 instead.
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32) && \
+    !defined(__ARM_BIG_ENDIAN)
+#include <arm_acle.h>
+#define BASE64_CRC32C_ARM
+#endif
+
+namespace base64 {
+
+namespace detail {
+
+inline constexpr uint32_t crc32c_polynomial{0x82F63B78};
+
+// Tables for slicing-by-8: tables[0] is the bytewise table, tables[k] advances
+// a byte through k further zero bytes.
+inline constexpr std::array<std::array<uint32_t, 256>, 8>
+make_crc32c_tables() {
+  std::array<std::array<uint32_t, 256>, 8> tables{};
+  for (uint32_t i = 0; i < 256; ++i) {
+    uint32_t crc = i;
+    for (int bit = 0; bit < 8; ++bit) {
+      crc = (crc >> 1) ^ ((crc & 1) != 0 ? crc32c_polynomial : 0);
+    }
+    tables[0][i] = crc;
+  }
+  for (size_t k = 1; k < 8; ++k) {
+    for (size_t i = 0; i < 256; ++i) {
+      const uint32_t prev = tables[k - 1][i];
+      tables[k][i] = (prev >> 8) ^ tables[0][prev & 0xFF];
+    }
+  }
+  return tables;
+}
+
+inline constexpr std::array<std::array<uint32_t, 256>, 8> crc32c_tables =
+    make_crc32c_tables();
+
+inline uint64_t load_le64(const uint8_t* bytes) noexcept {
+  uint64_t value = 0;
+  for (int i = 7; i >= 0; --i) {
+    value = (value << 8) | bytes[i];
+  }
+  return value;
+}
+
+inline uint32_t crc32c_software(uint32_t crc, const uint8_t* bytes,
+                                size_t size) noexcept {
+  const auto& t = crc32c_tables;
+  for (; size >= 8; size -= 8, bytes += 8) {
+    const uint64_t word = load_le64(bytes) ^ crc;
+    crc = t[7][word & 0xFF] ^ t[6][(word >> 8) & 0xFF] ^
+          t[5][(word >> 16) & 0xFF] ^ t[4][(word >> 24) & 0xFF] ^
+          t[3][(word >> 32) & 0xFF] ^ t[2][(word >> 40) & 0xFF] ^
+          t[1][(word >> 48) & 0xFF] ^ t[0][word >> 56];
+  }
+  for (; size != 0; --size) {
+    crc = (crc >> 8) ^ t[0][(crc ^ *bytes++) & 0xFF];
+  }
+  return crc;
+}
+
+#if defined(BASE64_CRC32C_X86)
+__attribute__((target("sse4.2"))) inline uint32_t crc32c_hardware(
+    uint32_t crc, const uint8_t* bytes, size_t size) noexcept {
+  uint64_t crc64 = crc;
+  for (; size >= 8; size -= 8, bytes += 8) {
+    uint64_t word;
+    std::memcpy(&word, bytes, 8);
+    crc64 = _mm_crc32_u64(crc64, word);
+  }
+  crc = static_cast<uint32_t>(crc64);
+  for (; size != 0; --size) {
+    crc = _mm_crc32_u8(crc, *bytes++);
+  }
+  return crc;
+}
+
+inline bool has_crc32c_instruction() noexcept {
+#if defined(__SSE4_2__)
+  return true;
+#else
+  static const bool supported = __builtin_cpu_supports("sse4.2");
+  return supported;
+#endif
+}
+#elif defined(BASE64_CRC32C_ARM)
+inline uint32_t crc32c_hardware(uint32_t crc, const uint8_t* bytes,
+                                size_t size) noexcept {
+  for (; size >= 8; size -= 8, bytes += 8) {
+    uint64_t word;
+    std::memcpy(&word, bytes, 8);
+    crc = __crc32cd(crc, word);
+  }
+  for (; size != 0; --size) {
+    crc = __crc32cb(crc, *bytes++);
+  }
+  return crc;
+}
+
+inline constexpr bool has_crc32c_instruction() noexcept { return true; }
+#endif
+
+}  // namespace detail
+
+// CRC-32C (Castagnoli) as used by iSCSI, ext4 and many object stores. Uses the
+// SSE4.2 or ARMv8 CRC instructions when the CPU has them.
+class crc32c {
+ public:
+  void update(const char* data, size_t size) noexcept {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+#if defined(BASE64_CRC32C_X86) || defined(BASE64_CRC32C_ARM)
+    if (detail::has_crc32c_instruction()) {
+      crc_ = detail::crc32c_hardware(crc_, bytes, size);
+      return;
+    }
+#endif
+    crc_ = detail::crc32c_software(crc_, bytes, size);
+  }
+
+  uint64_t value() const noexcept { return ~crc_; }
+
+ private:
+  uint32_t crc_ = 0xFFFFFFFF;
+};
+
+// xxHash64 with a configurable seed.
+class xxhash64 {
+ public:
+  explicit xxhash64(uint64_t seed = 0) noexcept
+      : seed_(seed),
+        acc_{seed + prime1 + prime2, seed + prime2, seed, seed - prime1} {}
+
+  void update(const char* data, size_t size) noexcept {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+    total_ += size;
+    if (buffered_ != 0) {
+      const size_t count = std::min(size, stripe - buffered_);
+      std::memcpy(buffer_.data() + buffered_, bytes, count);
+      buffered_ += count;
+      bytes += count;
+      size -= count;
+      if (buffered_ < stripe) {
+        return;
+      }
+      consume(buffer_.data());
+      buffered_ = 0;
+    }
+    for (; size >= stripe; size -= stripe, bytes += stripe) {
+      consume(bytes);
+    }
+    std::memcpy(buffer_.data(), bytes, size);
+    buffered_ = size;
+  }
+
+  uint64_t value() const noexcept {
+    uint64_t hash;
+    if (total_ >= stripe) {
+      hash = rotl(acc_[0], 1) + rotl(acc_[1], 7) + rotl(acc_[2], 12) +
+             rotl(acc_[3], 18);
+      for (uint64_t acc : acc_) {
+        hash = (hash ^ round(0, acc)) * prime1 + prime4;
+      }
+    } else {
+      hash = seed_ + prime5;
+    }
+    hash += total_;
+
+    const uint8_t* bytes = buffer_.data();
+    size_t size = buffered_;
+    for (; size >= 8; size -= 8, bytes += 8) {
+      hash = rotl(hash ^ round(0, detail::load_le64(bytes)), 27) * prime1 +
+             prime4;
+    }
+    if (size >= 4) {
+      uint64_t word = 0;
+      for (int i = 3; i >= 0; --i) {
+        word = (word << 8) | bytes[i];
+      }
+      hash = rotl(hash ^ (word * prime1), 23) * prime2 + prime3;
+      size -= 4;
+      bytes += 4;
+    }
+    for (; size != 0; --size) {
+      hash = rotl(hash ^ (*bytes++ * prime5), 11) * prime1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= prime2;
+    hash ^= hash >> 29;
+    hash *= prime3;
+    hash ^= hash >> 32;
+    return hash;
+  }
+
+ private:
+  static constexpr uint64_t prime1 = 0x9E3779B185EBCA87;
+  static constexpr uint64_t prime2 = 0xC2B2AE3D27D4EB4F;
+  static constexpr uint64_t prime3 = 0x165667B19E3779F9;
+  static constexpr uint64_t prime4 = 0x85EBCA77C2B2AE63;
+  static constexpr uint64_t prime5 = 0x27D4EB2F165667C5;
+  static constexpr size_t stripe = 32;
+
+  static constexpr uint64_t rotl(uint64_t x, int r) noexcept {
+    return (x << r) | (x >> (64 - r));
+  }
+  static constexpr uint64_t round(uint64_t acc, uint64_t input) noexcept {
+    return rotl(acc + input * prime2, 31) * prime1;
+  }
+
+  void consume(const uint8_t* bytes) noexcept {
+    for (size_t i = 0; i < 4; ++i) {
+      acc_[i] = round(acc_[i], detail::load_le64(bytes + i * 8));
+    }
+  }
+
+  uint64_t seed_;
+  std::array<uint64_t, 4> acc_;
+  std::array<uint8_t, stripe> buffer_{};
+  size_t buffered_ = 0;
+  uint64_t total_ = 0;
+};
+
+template <class OutputBuffer>
+struct checksummed {
+  OutputBuffer output;
+  // Checksum of the raw (unencoded) bytes.
+  uint64_t checksum;
+};
+
+namespace detail {
+
+// Number of groups per block. The checksum of a block is computed while the
+// block is still in the L1 cache, so the data is streamed from memory once.
+inline constexpr size_t checksum_block_quanta{4096};
+
+}  // namespace detail
+
+// Encodes `binaryText` and computes its checksum in the same pass. `Checksum`
+// may be any class with `update(const char*, size_t)` and `value()`.
+template <class OutputBuffer, class Checksum = crc32c,
+          alphabet A = alphabet::standard>
+inline checksummed<OutputBuffer> encode_into_with_checksum(
+    std::string_view binaryText, Checksum checksum = Checksum()) {
+  typedef typename OutputBuffer::value_type output_value_type;
+  static_assert(detail::is_byte_like_v<output_value_type>);
+  constexpr size_t blocksize = detail::checksum_block_quanta * 3;
+  detail::call_probe probe(operation::encode, binaryText.size());
+
+  const size_t encodedsize = encoded_size(binaryText.size());
+  OutputBuffer encoded = output_buffer_traits<OutputBuffer>::create(
+      encodedsize, [&](char* currEncoding) {
+        for (size_t pos = 0; pos < binaryText.size(); pos += blocksize) {
+          const size_t count = std::min(blocksize, binaryText.size() - pos);
+          checksum.update(binaryText.data() + pos, count);
+          detail::encode<A>(
+              reinterpret_cast<const uint8_t*>(binaryText.data() + pos), count,
+              currEncoding);
+          currEncoding += encoded_size(count);
+        }
+      });
+  probe.complete(encodedsize, kernel::scalar);
+  return {std::move(encoded), checksum.value()};
+}
+
+// Decodes `base64Text` and computes the checksum of the decoded bytes in the
+// same pass.
+template <class OutputBuffer, class Checksum = crc32c,
+          alphabet A = alphabet::standard>
+inline checksummed<OutputBuffer> decode_into_with_checksum(
+    std::string_view base64Text, Checksum checksum = Checksum()) {
+  typedef typename OutputBuffer::value_type output_value_type;
+  static_assert(detail::is_byte_like_v<output_value_type>);
+  constexpr size_t blocksize = detail::checksum_block_quanta * 4;
+  detail::call_probe probe(operation::decode, base64Text.size());
+
+  const size_t numPadding = detail::count_padding<A>(base64Text);
+  const size_t decodedsize =
+      detail::decoded_size(base64Text.size(), numPadding);
+  OutputBuffer decoded = output_buffer_traits<OutputBuffer>::create(
+      decodedsize, [&](char* currDecoding) {
+        for (size_t pos = 0; pos < base64Text.size(); pos += blocksize) {
+          const std::string_view block = base64Text.substr(pos, blocksize);
+          size_t count = block.size() / 4 * 3;
+          if (pos + blocksize >= base64Text.size()) {
+            detail::decode<A>(block, numPadding, currDecoding);
+            count = detail::decoded_size(block.size(), numPadding);
+          } else if (!detail::decode_quanta<A>(
+                         reinterpret_cast<const uint8_t*>(block.data()),
+                         block.size() / 4, currDecoding)) {
+            detail::record_error(decode_error::invalid_character);
+            throw std::runtime_error{
+                "Invalid base64 encoded data - Invalid character"};
+          }
+          checksum.update(currDecoding, count);
+          currDecoding += count;
+        }
+      });
+  probe.complete(decodedsize, kernel::scalar);
+  return {std::move(decoded), checksum.value()};
+}
+
+}  // namespace base64
+
+#endif  // BASE64_CHECKSUM_HPP_
@@ -0,0 +1,69 @@
+#ifndef BASE64_DECL_HPP_
+#define BASE64_DECL_HPP_
+
+// Declarations of the most common base64 functions without their
+// definitions or tables. Translation units that include only this header
+// must link `base64::base64_static`, which instantiates the functions for
+// std::string, std::vector<uint8_t> and std::vector<std::byte> outputs.
+// base64.hpp includes this header, so both can be mixed freely.
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace base64 {
+
+// The alphabets of RFC 4648: `standard` uses '+' and '/' (section 4), `url`
+// uses '-' and '_' (section 5). Decoding with the `url` alphabet also accepts
+// input without padding.
+enum class alphabet { standard, url };
+
+// Whether encoded text ends with '=' padding to a multiple of four characters.
+enum class padding { padded, unpadded };
+
+template <class OutputBuffer, alphabet A = alphabet::standard>
+OutputBuffer encode_into(std::string_view data);
+
+template <class OutputBuffer, alphabet A = alphabet::standard>
+OutputBuffer decode_into(std::string_view base64Text);
+
+inline std::string to_base64(std::string_view data) {
+  return encode_into<std::string>(data);
+}
+
+inline std::string to_base64url(std::string_view data) {
+  return encode_into<std::string, alphabet::url>(data);
+}
+
+inline std::string from_base64(std::string_view data) {
+  return decode_into<std::string>(data);
+}
+
+inline std::string from_base64url(std::string_view data) {
+  return decode_into<std::string, alphabet::url>(data);
+}
+
+// Defined for users of `base64::base64_static` so that the common
+// instantiations are only compiled once, in the library.
+#if defined(BASE64_EXTERN_TEMPLATES)
+#define BASE64_DECLARE_INSTANTIATIONS(OutputBuffer, A)                  \
+  extern template OutputBuffer encode_into<OutputBuffer, A>(           \
+      std::string_view);                                               \
+  extern template OutputBuffer decode_into<OutputBuffer, A>(           \
+      std::string_view);
+
+BASE64_DECLARE_INSTANTIATIONS(std::string, alphabet::standard)
+BASE64_DECLARE_INSTANTIATIONS(std::string, alphabet::url)
+BASE64_DECLARE_INSTANTIATIONS(std::vector<std::uint8_t>, alphabet::standard)
+BASE64_DECLARE_INSTANTIATIONS(std::vector<std::uint8_t>, alphabet::url)
+BASE64_DECLARE_INSTANTIATIONS(std::vector<std::byte>, alphabet::standard)
+BASE64_DECLARE_INSTANTIATIONS(std::vector<std::byte>, alphabet::url)
+
+#undef BASE64_DECLARE_INSTANTIATIONS
+#endif
+
+}  // namespace base64
+
+#endif  // BASE64_DECL_HPP_
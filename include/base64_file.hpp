@@ -0,0 +1,323 @@
+#ifndef BASE64_FILE_HPP_
+#define BASE64_FILE_HPP_
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "base64.hpp"
+
+#if defined(_WIN32)
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace base64 {
+
+struct pipeline_options {
+  // Number of input bytes read per buffer. Rounded down to a multiple of 12
+  // so that every full buffer holds whole groups in both directions.
+  size_t block_size = size_t{1} << 20;
+  // Number of buffers in flight between the read, transcode and write stages.
+  // Memory use is bounded by about `buffers * block_size * 7 / 3`.
+  size_t buffers = 4;
+};
+
+namespace detail {
+
+#if defined(_WIN32)
+inline int read_some(int fd, char* data, size_t size) {
+  return ::_read(fd, data,
+                 static_cast<unsigned>(std::min<size_t>(size, 1 << 30)));
+}
+inline int write_some(int fd, const char* data, size_t size) {
+  return ::_write(fd, data,
+                  static_cast<unsigned>(std::min<size_t>(size, 1 << 30)));
+}
+inline int open_for_reading(const std::string& path) {
+  return ::_open(path.c_str(), _O_RDONLY | _O_BINARY);
+}
+inline int open_for_writing(const std::string& path) {
+  return ::_open(path.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY,
+                 _S_IREAD | _S_IWRITE);
+}
+inline void close_file(int fd) { ::_close(fd); }
+#else
+inline ssize_t read_some(int fd, char* data, size_t size) {
+  return ::read(fd, data, size);
+}
+inline ssize_t write_some(int fd, const char* data, size_t size) {
+  return ::write(fd, data, size);
+}
+inline int open_for_reading(const std::string& path) {
+  return ::open(path.c_str(), O_RDONLY);
+}
+inline int open_for_writing(const std::string& path) {
+  return ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+}
+inline void close_file(int fd) { ::close(fd); }
+#endif
+
+// Reads until `size` bytes are read or the end of the file is reached.
+inline size_t read_full(int fd, char* data, size_t size) {
+  size_t count = 0;
+  while (count < size) {
+    const auto result = read_some(fd, data + count, size - count);
+    if (result == 0) {
+      break;
+    }
+    if (result < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::system_error{errno, std::generic_category(),
+                              "Reading base64 pipeline input failed"};
+    }
+    count += static_cast<size_t>(result);
+  }
+  return count;
+}
+
+inline void write_full(int fd, const char* data, size_t size) {
+  while (size != 0) {
+    const auto result = write_some(fd, data, size);
+    if (result < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::system_error{errno, std::generic_category(),
+                              "Writing base64 pipeline output failed"};
+    }
+    data += result;
+    size -= static_cast<size_t>(result);
+  }
+}
+
+class file_handle {
+ public:
+  explicit file_handle(int fd, const std::string& path) : fd_(fd) {
+    if (fd_ < 0) {
+      throw std::system_error{errno, std::generic_category(),
+                              "Opening " + path + " failed"};
+    }
+  }
+  file_handle(const file_handle&) = delete;
+  file_handle& operator=(const file_handle&) = delete;
+  ~file_handle() { close_file(fd_); }
+
+  int get() const noexcept { return fd_; }
+
+ private:
+  int fd_;
+};
+
+// Runs a read -> transcode -> write pipeline over a ring of buffers. Reading
+// and writing happen on worker threads while the calling thread transcodes,
+// so that I/O and computation overlap.
+class transcode_pipeline {
+ public:
+  transcode_pipeline(const pipeline_options& options, size_t inputsize,
+                     size_t outputsize)
+      : slots_(std::max<size_t>(options.buffers, 2)), inputsize_(inputsize) {
+    for (auto& s : slots_) {
+      s.input.reset(new char[inputsize]);
+      s.output.reset(new char[outputsize]);
+    }
+  }
+
+  // `transcode(input, size, output)` returns the number of bytes written to
+  // `output`.
+  template <class Transcode>
+  uint64_t run(int in, int out, Transcode transcode) {
+    uint64_t total = 0;
+    std::thread reader([&] {
+      guarded([&] { read_loop(in); });
+    });
+    std::thread writer([&] {
+      guarded([&] { total = write_loop(out); });
+    });
+    guarded([&] { transcode_loop(transcode); });
+    reader.join();
+    writer.join();
+    if (error_) {
+      std::rethrow_exception(error_);
+    }
+    return total;
+  }
+
+ private:
+  enum class state { free, filled, transcoded };
+
+  struct slot {
+    std::unique_ptr<char[]> input;
+    std::unique_ptr<char[]> output;
+    size_t inputsize = 0;
+    size_t outputsize = 0;
+    bool last = false;
+    state status = state::free;
+  };
+
+  template <class Fn>
+  void guarded(Fn fn) {
+    try {
+      fn();
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!error_) {
+        error_ = std::current_exception();
+      }
+      changed_.notify_all();
+    }
+  }
+
+  // Waits until `s` reaches `status`. Returns false if the pipeline failed.
+  bool wait_for(const slot& s, state status) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    changed_.wait(lock, [&] { return s.status == status || error_; });
+    return !error_;
+  }
+
+  void publish(slot& s, state status) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    s.status = status;
+    changed_.notify_all();
+  }
+
+  void read_loop(int in) {
+    for (size_t seq = 0;; ++seq) {
+      slot& s = slots_[seq % slots_.size()];
+      if (!wait_for(s, state::free)) {
+        return;
+      }
+      s.inputsize = read_full(in, s.input.get(), inputsize_);
+      s.last = s.inputsize < inputsize_;
+      publish(s, state::filled);
+      if (s.last) {
+        return;
+      }
+    }
+  }
+
+  template <class Transcode>
+  void transcode_loop(Transcode& transcode) {
+    for (size_t seq = 0;; ++seq) {
+      slot& s = slots_[seq % slots_.size()];
+      if (!wait_for(s, state::filled)) {
+        return;
+      }
+      s.outputsize = transcode(s.input.get(), s.inputsize, s.output.get());
+      const bool last = s.last;
+      publish(s, state::transcoded);
+      if (last) {
+        return;
+      }
+    }
+  }
+
+  uint64_t write_loop(int out) {
+    uint64_t total = 0;
+    for (size_t seq = 0;; ++seq) {
+      slot& s = slots_[seq % slots_.size()];
+      if (!wait_for(s, state::transcoded)) {
+        return total;
+      }
+      write_full(out, s.output.get(), s.outputsize);
+      total += s.outputsize;
+      const bool last = s.last;
+      publish(s, state::free);
+      if (last) {
+        return total;
+      }
+    }
+  }
+
+  std::vector<slot> slots_;
+  const size_t inputsize_;
+  std::mutex mutex_;
+  std::condition_variable changed_;
+  std::exception_ptr error_;
+};
+
+inline size_t pipeline_block_size(const pipeline_options& options) {
+  return std::max<size_t>(options.block_size / 12 * 12, 12);
+}
+
+}  // namespace detail
+
+// Encodes everything read from the file descriptor `in` to `out` and returns
+// the number of characters written. Memory use is bounded by `options`
+// regardless of the input size.
+template <alphabet A = alphabet::standard>
+inline uint64_t encode_file(int in, int out,
+                            const pipeline_options& options = {}) {
+  const size_t blocksize = detail::pipeline_block_size(options);
+  detail::transcode_pipeline pipeline(options, blocksize,
+                                      encoded_size(blocksize));
+  return pipeline.run(in, out,
+                      [](const char* input, size_t size, char* output) {
+                        detail::encode<A>(
+                            reinterpret_cast<const uint8_t*>(input), size,
+                            output);
+                        return encoded_size(size);
+                      });
+}
+
+// Decodes everything read from the file descriptor `in` to `out` and returns
+// the number of bytes written. The input must not contain line breaks.
+// Output written before invalid input is detected is left in `out`.
+template <alphabet A = alphabet::standard>
+inline uint64_t decode_file(int in, int out,
+                            const pipeline_options& options = {}) {
+  const size_t blocksize = detail::pipeline_block_size(options);
+  detail::transcode_pipeline pipeline(options, blocksize, blocksize / 4 * 3);
+  bool padded = false;
+  return pipeline.run(
+      in, out,
+      [&padded](const char* input, size_t size, char* output) {
+        if (padded && size != 0) {
+          throw std::runtime_error{
+              "Invalid base64 encoded data - Data after padding"};
+        }
+        const std::string_view base64Text(input, size);
+        const size_t numPadding = detail::count_padding<A>(base64Text);
+        detail::decode<A>(base64Text, numPadding, output);
+        padded = numPadding != 0;
+        return detail::decoded_size(size, numPadding);
+      });
+}
+
+template <alphabet A = alphabet::standard>
+inline uint64_t encode_file(const std::string& inPath,
+                            const std::string& outPath,
+                            const pipeline_options& options = {}) {
+  const detail::file_handle in(detail::open_for_reading(inPath), inPath);
+  const detail::file_handle out(detail::open_for_writing(outPath), outPath);
+  return encode_file<A>(in.get(), out.get(), options);
+}
+
+template <alphabet A = alphabet::standard>
+inline uint64_t decode_file(const std::string& inPath,
+                            const std::string& outPath,
+                            const pipeline_options& options = {}) {
+  const detail::file_handle in(detail::open_for_reading(inPath), inPath);
+  const detail::file_handle out(detail::open_for_writing(outPath), outPath);
+  return decode_file<A>(in.get(), out.get(), options);
+}
+
+}  // namespace base64
+
+#endif  // BASE64_FILE_HPP_
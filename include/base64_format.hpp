@@ -0,0 +1,152 @@
+#ifndef BASE64_FORMAT_HPP_
+#define BASE64_FORMAT_HPP_
+
+// Formatting of binary data as base64 with std::format (C++20) and, if
+// <fmt/format.h> is included before this header, with fmt::format:
+//
+//   std::format("key={}", base64::as_base64(key))
+//
+// The bytes are encoded block by block straight into the output of the format
+// call, without a temporary string. The format spec accepts, in any order:
+//   u    the url alphabet
+//   n    no padding
+//   .N   at most N characters, followed by "..." if the text was truncated
+
+#include <algorithm>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+#include "base64.hpp"
+
+#if __has_include(<format>)
+#include <format>
+#endif
+
+namespace base64 {
+
+// Bytes to be formatted as base64. Refers to the bytes, which must outlive
+// the format call.
+struct format_view {
+  std::string_view bytes;
+};
+
+// Accepts anything with data() and size() whose elements are byte-like.
+template <class Bytes,
+          std::enable_if_t<
+              !std::is_convertible_v<const Bytes&, std::string_view>, int> = 0>
+inline format_view as_base64(const Bytes& bytes) {
+  return {detail::segment_bytes(bytes)};
+}
+
+inline format_view as_base64(std::string_view bytes) { return {bytes}; }
+
+namespace detail {
+
+// Number of groups encoded into the stack buffer at a time.
+inline constexpr size_t format_block_quanta{256};
+
+inline constexpr std::string_view format_ellipsis{"..."};
+
+struct format_spec {
+  bool url = false;
+  bool padded = true;
+  size_t max_size = static_cast<size_t>(-1);
+};
+
+// Parses the spec at [begin, end) up to the closing brace and returns the
+// position of the brace. Calls `fail(message)`, which must throw, on an
+// invalid spec.
+template <class Iterator, class Fail>
+constexpr Iterator parse_format_spec(Iterator begin, Iterator end,
+                                     format_spec& spec, Fail&& fail) {
+  while (begin != end && *begin != '}') {
+    if (*begin == 'u') {
+      spec.url = true;
+      ++begin;
+    } else if (*begin == 'n') {
+      spec.padded = false;
+      ++begin;
+    } else if (*begin == '.') {
+      ++begin;
+      if (begin == end || *begin < '0' || *begin > '9') {
+        fail("Invalid base64 format spec - Missing precision");
+      }
+      spec.max_size = 0;
+      for (; begin != end && *begin >= '0' && *begin <= '9'; ++begin) {
+        spec.max_size =
+            spec.max_size * 10 + static_cast<size_t>(*begin - '0');
+      }
+    } else {
+      fail("Invalid base64 format spec");
+    }
+  }
+  return begin;
+}
+
+template <alphabet A, class OutputIterator>
+inline OutputIterator format_base64(std::string_view bytes,
+                                    const format_spec& spec,
+                                    OutputIterator out) {
+  const size_t size = spec.padded ? encoded_size(bytes.size())
+                                  : unpadded_size(bytes.size());
+  size_t remaining = std::min(size, spec.max_size);
+  const bool truncated = remaining < size;
+
+  constexpr size_t blocksize = format_block_quanta * 3;
+  char encoded[format_block_quanta * 4];
+  for (size_t pos = 0; remaining != 0; pos += blocksize) {
+    const size_t count = std::min(blocksize, bytes.size() - pos);
+    encode<A>(reinterpret_cast<const uint8_t*>(bytes.data() + pos), count,
+              encoded);
+    const size_t chars = std::min(remaining, encoded_size(count));
+    out = std::copy(encoded, encoded + chars, out);
+    remaining -= chars;
+  }
+  if (truncated) {
+    out = std::copy(format_ellipsis.begin(), format_ellipsis.end(), out);
+  }
+  return out;
+}
+
+// The parse() and format() members shared by the std and fmt formatters.
+template <class FormatError>
+class formatter_base {
+ public:
+  template <class ParseContext>
+  constexpr auto parse(ParseContext& ctx) {
+    return parse_format_spec(ctx.begin(), ctx.end(), spec_,
+                             [](const char* message) {
+                               throw FormatError(message);
+                             });
+  }
+
+  template <class FormatContext>
+  auto format(const format_view& view, FormatContext& ctx) const {
+    if (spec_.url) {
+      return format_base64<alphabet::url>(view.bytes, spec_, ctx.out());
+    }
+    return format_base64<alphabet::standard>(view.bytes, spec_, ctx.out());
+  }
+
+ private:
+  format_spec spec_;
+};
+
+}  // namespace detail
+
+}  // namespace base64
+
+#if defined(__cpp_lib_format)
+template <>
+struct std::formatter<base64::format_view, char>
+    : base64::detail::formatter_base<std::format_error> {};
+#endif
+
+#if defined(FMT_VERSION)
+template <>
+struct fmt::formatter<base64::format_view, char>
+    : base64::detail::formatter_base<fmt::format_error> {};
+#endif
+
+#endif  // BASE64_FORMAT_HPP_
@@ -0,0 +1,227 @@
+#ifndef BASE64_RANGES_HPP_
+#define BASE64_RANGES_HPP_
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+#include "base64.hpp"
+
+#if !defined(__cpp_lib_ranges)
+#error "base64_ranges.hpp requires C++20 ranges"
+#endif
+
+namespace base64 {
+
+namespace detail {
+
+// Number of groups transcoded at once by the views, sized so that the input
+// and output blocks together stay well inside the L1 cache.
+inline constexpr size_t view_block_quanta{1024};
+
+template <alphabet A>
+struct encode_block {
+  static constexpr size_t input_size = view_block_quanta * 3;
+  static constexpr size_t output_size = view_block_quanta * 4;
+
+  static constexpr size_t transcoded_size(size_t size) noexcept {
+    return encoded_size(size);
+  }
+
+  // `size` is a multiple of 3 unless `last` is set.
+  static size_t run(const char* input, size_t size, bool /*last*/,
+                    char* output) {
+    encode<A>(reinterpret_cast<const uint8_t*>(input), size, output);
+    return encoded_size(size);
+  }
+};
+
+template <alphabet A>
+struct decode_block {
+  static constexpr size_t input_size = view_block_quanta * 4;
+  static constexpr size_t output_size = view_block_quanta * 3;
+
+  // `size` is a multiple of 4 unless `last` is set. Only the last block may
+  // be padded.
+  static size_t run(const char* input, size_t size, bool last, char* output) {
+    if (last) {
+      const std::string_view base64Text(input, size);
+      const size_t numPadding = count_padding<A>(base64Text);
+      decode<A>(base64Text, numPadding, output);
+      return decoded_size(size, numPadding);
+    }
+    if (!decode_quanta<A>(reinterpret_cast<const uint8_t*>(input), size / 4,
+                          output)) {
+      record_error(decode_error::invalid_character);
+      throw std::runtime_error{
+          "Invalid base64 encoded data - Invalid character"};
+    }
+    return size / 4 * 3;
+  }
+};
+
+// Input view that transcodes the underlying range one block at a time as it
+// is iterated. The blocks live in the view, so iterators are cheap and
+// `begin()` may only be called once. Errors are thrown from `begin()` and
+// `operator++`.
+template <std::ranges::input_range V, class Block>
+  requires std::ranges::view<V> &&
+           is_byte_like_v<std::remove_cv_t<std::ranges::range_value_t<V>>>
+class block_view : public std::ranges::view_interface<block_view<V, Block>> {
+ public:
+  class iterator {
+   public:
+    typedef std::input_iterator_tag iterator_concept;
+    typedef char value_type;
+    typedef std::ptrdiff_t difference_type;
+
+    iterator() = default;
+    explicit iterator(block_view* parent) : parent_(parent) {}
+
+    char operator*() const { return parent_->state_->output[parent_->pos_]; }
+
+    iterator& operator++() {
+      parent_->advance();
+      return *this;
+    }
+    void operator++(int) { ++*this; }
+
+    friend bool operator==(const iterator& it, std::default_sentinel_t) {
+      return it.at_end();
+    }
+
+   private:
+    bool at_end() const { return parent_->pos_ == parent_->size_; }
+
+    block_view* parent_ = nullptr;
+  };
+
+  block_view()
+    requires std::default_initializable<V>
+  = default;
+  explicit block_view(V base) : base_(std::move(base)) {}
+
+  V base() const&
+    requires std::copy_constructible<V>
+  {
+    return base_;
+  }
+  V base() && { return std::move(base_); }
+
+  iterator begin() {
+    state_ = std::make_unique<state>();
+    current_.emplace(std::ranges::begin(base_));
+    fill();
+    return iterator(this);
+  }
+  std::default_sentinel_t end() const noexcept {
+    return std::default_sentinel;
+  }
+
+  // Only known up front for encoding, as decoding depends on the padding.
+  size_t size()
+    requires std::ranges::sized_range<V> &&
+             requires { Block::transcoded_size(size_t{}); }
+  {
+    return Block::transcoded_size(std::ranges::size(base_));
+  }
+  size_t size() const
+    requires std::ranges::sized_range<const V> &&
+             requires { Block::transcoded_size(size_t{}); }
+  {
+    return Block::transcoded_size(std::ranges::size(base_));
+  }
+
+ private:
+  struct state {
+    char input[Block::input_size];
+    char output[Block::output_size];
+  };
+
+  void advance() {
+    if (++pos_ == size_) {
+      fill();
+    }
+  }
+
+  // Transcodes the next block. Leaves `pos_ == size_` at the end of the input.
+  void fill() {
+    pos_ = 0;
+    size_ = 0;
+    while (size_ == 0 && !done_) {
+      auto& it = *current_;
+      const auto last = std::ranges::end(base_);
+      size_t count = 0;
+      if constexpr (std::ranges::contiguous_range<V> &&
+                    std::sized_sentinel_for<std::ranges::sentinel_t<V>,
+                                            std::ranges::iterator_t<V>>) {
+        count = std::min<size_t>(Block::input_size,
+                                 static_cast<size_t>(last - it));
+        if (count != 0) {
+          std::memcpy(state_->input, std::to_address(it), count);
+        }
+        it += static_cast<std::ranges::range_difference_t<V>>(count);
+      } else {
+        for (; count < Block::input_size && it != last; ++it, ++count) {
+          state_->input[count] = static_cast<char>(*it);
+        }
+      }
+      done_ = it == last;
+      size_ = Block::run(state_->input, count, done_, state_->output);
+    }
+  }
+
+  V base_ = V();
+  std::optional<std::ranges::iterator_t<V>> current_;
+  std::unique_ptr<state> state_;
+  size_t pos_ = 0;
+  size_t size_ = 0;
+  bool done_ = false;
+};
+
+template <class Block>
+struct block_view_fn {
+  template <std::ranges::viewable_range R>
+  auto operator()(R&& r) const {
+    return block_view<std::views::all_t<R>, Block>(
+        std::views::all(std::forward<R>(r)));
+  }
+
+  template <std::ranges::viewable_range R>
+  friend auto operator|(R&& r, const block_view_fn& fn) {
+    return fn(std::forward<R>(r));
+  }
+};
+
+}  // namespace detail
+
+template <class V, alphabet A = alphabet::standard>
+using encode_view = detail::block_view<V, detail::encode_block<A>>;
+template <class V, alphabet A = alphabet::standard>
+using decode_view = detail::block_view<V, detail::decode_block<A>>;
+
+// Lazy range adaptors. For example, `data | base64::views::decode |
+// std::views::take(8)` decodes only the first block of `data`.
+namespace views {
+
+inline constexpr detail::block_view_fn<detail::encode_block<alphabet::standard>>
+    encode{};
+inline constexpr detail::block_view_fn<detail::decode_block<alphabet::standard>>
+    decode{};
+inline constexpr detail::block_view_fn<detail::encode_block<alphabet::url>>
+    encode_url{};
+inline constexpr detail::block_view_fn<detail::decode_block<alphabet::url>>
+    decode_url{};
+
+}  // namespace views
+
+}  // namespace base64
+
+#endif  // BASE64_RANGES_HPP_
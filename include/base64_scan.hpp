@@ -0,0 +1,177 @@
+#ifndef BASE64_SCAN_HPP_
+#define BASE64_SCAN_HPP_
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "base64.hpp"
+
+namespace base64 {
+
+struct scan_options {
+  // Runs shorter than this, counted in characters including the padding, are
+  // not reported.
+  size_t min_length = 16;
+  // Only report runs that directly follow a `data:[<mediatype>];base64,`
+  // prefix, as in data URIs.
+  bool data_uri = false;
+};
+
+struct scan_match {
+  // Position of the first base64 character of the run in the scanned text.
+  size_t offset = 0;
+  // Number of characters in the run, including the padding.
+  size_t size = 0;
+};
+
+namespace detail {
+
+// Number of groups decoded at once while following a run.
+inline constexpr size_t scan_block_quanta{64};
+
+// Longest media type, including parameters, accepted before `;base64,`.
+inline constexpr size_t max_data_uri_media_type{256};
+
+template <alphabet A>
+inline bool is_base64_char(char c) noexcept {
+  return tables<A>::decode_0[static_cast<uint8_t>(c)] < bad_char;
+}
+
+inline bool ends_uri(char c) noexcept {
+  return static_cast<unsigned char>(c) <= ' ' || c == '"' || c == '\'' ||
+         c == '<' || c == '>' || c == '(' || c == ')' || c == ',';
+}
+
+inline bool iequals(std::string_view lhs, std::string_view rhs) noexcept {
+  return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(),
+                    [](char a, char b) {
+                      return (a >= 'A' && a <= 'Z' ? a - 'A' + 'a' : a) == b;
+                    });
+}
+
+// Returns the position after the next `data:...;base64,` prefix at or after
+// `pos`, or std::string_view::npos.
+inline size_t find_data_uri(std::string_view text, size_t pos) {
+  constexpr std::string_view scheme{"data:"};
+  constexpr std::string_view marker{";base64"};
+  while ((pos = text.find(scheme, pos)) != std::string_view::npos) {
+    pos += scheme.size();
+    size_t end = pos;
+    while (end < text.size() && end - pos < max_data_uri_media_type &&
+           !ends_uri(text[end])) {
+      ++end;
+    }
+    if (end < text.size() && text[end] == ',' && end - pos >= marker.size() &&
+        iequals(text.substr(end - marker.size(), marker.size()), marker)) {
+      return end + 1;
+    }
+  }
+  return std::string_view::npos;
+}
+
+// Decodes the run of base64 characters starting at `pos` into `decoded` and
+// stores its extent in `match`. The decode kernel itself finds the end of the
+// run: whole groups are decoded in blocks, and a block that fails is retried
+// group by group. A final partial group is only part of the run if it is
+// correctly padded (or unpadded for the url alphabet); otherwise the run ends
+// with the last whole group. Returns the position after the characters
+// consumed, which includes any such undecodable rest of the run.
+template <alphabet A>
+inline size_t decode_run(std::string_view text, size_t pos,
+                         std::string& decoded, scan_match& match) {
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(text.data());
+  const size_t start = pos;
+  decoded.clear();
+
+  size_t block = scan_block_quanta;
+  while (text.size() - pos >= 4) {
+    const size_t quanta = std::min(block, (text.size() - pos) / 4);
+    const size_t offset = decoded.size();
+    decoded.resize(offset + quanta * 3);
+    if (decode_quanta<A>(bytes + pos, quanta, decoded.data() + offset)) {
+      pos += quanta * 4;
+      continue;
+    }
+    decoded.resize(offset);
+    if (block == 1) {
+      break;
+    }
+    block = 1;
+  }
+
+  size_t chars = 0;
+  while (chars < 3 && pos + chars < text.size() &&
+         is_base64_char<A>(text[pos + chars])) {
+    ++chars;
+  }
+  size_t numPadding = 0;
+  while (pos + chars + numPadding < text.size() &&
+         text[pos + chars + numPadding] == '=') {
+    ++numPadding;
+  }
+  const size_t end = pos + chars + numPadding;
+
+  if (chars >= 2 && (numPadding == 4 - chars ||
+                     (A == alphabet::url && numPadding == 0))) {
+    const size_t offset = decoded.size();
+    decoded.resize(offset + chars - 1);
+    decode_tail<A>(bytes + pos, 4 - chars, decoded.data() + offset);
+    match = scan_match{start, end - start};
+  } else {
+    match = scan_match{start, pos - start};
+  }
+  return end;
+}
+
+}  // namespace detail
+
+// Finds the maximal runs of base64 in `text`, e.g. embedded in HTML, JSON or
+// log lines, and decodes them in the same pass. For every run that is at
+// least `options.min_length` characters long, `sink(const scan_match&,
+// std::string_view decoded)` is called with the decoded bytes, which are only
+// valid during the call. Returns the matches in order.
+template <alphabet A = alphabet::standard, class Sink>
+inline std::vector<scan_match> scan(std::string_view text, Sink&& sink,
+                                    const scan_options& options = {}) {
+  std::vector<scan_match> matches;
+  std::string decoded;
+  size_t pos = 0;
+  while (pos < text.size()) {
+    if (options.data_uri) {
+      pos = detail::find_data_uri(text, pos);
+      if (pos == std::string_view::npos) {
+        break;
+      }
+    } else {
+      while (pos < text.size() && !detail::is_base64_char<A>(text[pos])) {
+        ++pos;
+      }
+      if (pos == text.size()) {
+        break;
+      }
+    }
+
+    scan_match match;
+    pos = detail::decode_run<A>(text, pos, decoded, match);
+    if (match.size != 0 && match.size >= options.min_length) {
+      matches.push_back(match);
+      sink(static_cast<const scan_match&>(match), std::string_view(decoded));
+    }
+  }
+  return matches;
+}
+
+// Like scan(), but only returns where the runs are.
+template <alphabet A = alphabet::standard>
+inline std::vector<scan_match> find_runs(std::string_view text,
+                                         const scan_options& options = {}) {
+  return scan<A>(
+      text, [](const scan_match&, std::string_view) {}, options);
+}
+
+}  // namespace base64
+
+#endif  // BASE64_SCAN_HPP_
@@ -0,0 +1,218 @@
+#ifndef BASE64_STREAM_HPP_
+#define BASE64_STREAM_HPP_
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <streambuf>
+#include <string_view>
+
+#include "base64.hpp"
+
+namespace base64 {
+
+inline constexpr size_t default_stream_buffer_size{size_t{1} << 16};
+
+// Output stream buffer that base64 encodes everything written to it into
+// another stream buffer. Data is collected in an internal buffer so that it
+// is encoded in large blocks. The trailing bytes and the padding are only
+// written by close(), which the destructor calls if needed.
+template <alphabet A = alphabet::standard>
+class basic_encoding_streambuf : public std::streambuf {
+ public:
+  explicit basic_encoding_streambuf(
+      std::streambuf* sink, size_t bufferSize = default_stream_buffer_size)
+      : sink_(sink),
+        inputsize_(std::max<size_t>(bufferSize / 3, 1) * 3),
+        input_(new char[inputsize_]),
+        output_(new char[encoded_size(inputsize_)]) {
+    setp(input_.get(), input_.get() + inputsize_);
+  }
+
+  basic_encoding_streambuf(const basic_encoding_streambuf&) = delete;
+  basic_encoding_streambuf& operator=(const basic_encoding_streambuf&) =
+      delete;
+
+  ~basic_encoding_streambuf() override {
+    try {
+      close();
+    } catch (...) {
+    }
+  }
+
+  // Encodes the remaining bytes including the padding and flushes the sink.
+  // Nothing can be written afterwards. Returns false if writing failed.
+  bool close() {
+    if (closed_) {
+      return true;
+    }
+    closed_ = true;
+    const size_t size = static_cast<size_t>(pptr() - pbase());
+    setp(nullptr, nullptr);
+    detail::encode<A>(reinterpret_cast<const uint8_t*>(input_.get()), size,
+                      output_.get());
+    return write(output_.get(), encoded_size(size)) && sink_->pubsync() == 0;
+  }
+
+ protected:
+  int_type overflow(int_type ch) override {
+    if (closed_ || !flush_quanta()) {
+      return traits_type::eof();
+    }
+    if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+      *pptr() = traits_type::to_char_type(ch);
+      pbump(1);
+    }
+    return traits_type::not_eof(ch);
+  }
+
+  std::streamsize xsputn(const char* s, std::streamsize count) override {
+    if (closed_ || count <= 0) {
+      return 0;
+    }
+    size_t n = static_cast<size_t>(count);
+    if (n <= static_cast<size_t>(epptr() - pptr())) {
+      std::memcpy(pptr(), s, n);
+      pbump(static_cast<int>(n));
+      return count;
+    }
+
+    // Complete the buffered group, then encode whole groups straight from
+    // `s` without copying them into the put area.
+    const size_t missing =
+        std::min((3 - static_cast<size_t>(pptr() - pbase()) % 3) % 3, n);
+    std::memcpy(pptr(), s, missing);
+    pbump(static_cast<int>(missing));
+    s += missing;
+    n -= missing;
+    if (!flush_quanta()) {
+      return count - static_cast<std::streamsize>(n);
+    }
+    while (n >= 3) {
+      const size_t size = std::min(n / 3 * 3, inputsize_);
+      detail::encode_quanta<A>(reinterpret_cast<const uint8_t*>(s), size / 3,
+                               output_.get());
+      if (!write(output_.get(), size / 3 * 4)) {
+        return count - static_cast<std::streamsize>(n);
+      }
+      s += size;
+      n -= size;
+    }
+    std::memcpy(pptr(), s, n);
+    pbump(static_cast<int>(n));
+    return count;
+  }
+
+  // Writes all complete groups, keeping up to two bytes until more data or
+  // close() arrives.
+  int sync() override {
+    return !closed_ && flush_quanta() && sink_->pubsync() == 0 ? 0 : -1;
+  }
+
+ private:
+  bool write(const char* data, size_t size) {
+    return sink_->sputn(data, static_cast<std::streamsize>(size)) ==
+           static_cast<std::streamsize>(size);
+  }
+
+  // Encodes and writes the complete groups in the put area and moves the
+  // remaining bytes to its front.
+  bool flush_quanta() {
+    const size_t size = static_cast<size_t>(pptr() - pbase());
+    const size_t quanta = size / 3;
+    detail::encode_quanta<A>(reinterpret_cast<const uint8_t*>(pbase()),
+                             quanta, output_.get());
+    if (!write(output_.get(), quanta * 4)) {
+      return false;
+    }
+    const size_t remaining = size - quanta * 3;
+    std::memmove(input_.get(), pbase() + quanta * 3, remaining);
+    setp(input_.get(), input_.get() + inputsize_);
+    pbump(static_cast<int>(remaining));
+    return true;
+  }
+
+  std::streambuf* sink_;
+  const size_t inputsize_;
+  std::unique_ptr<char[]> input_;
+  std::unique_ptr<char[]> output_;
+  bool closed_ = false;
+};
+
+// Input stream buffer that decodes base64 read from another stream buffer.
+// The input is read and decoded in large blocks and must not contain line
+// breaks. Invalid input throws std::runtime_error, which the standard streams
+// report by setting badbit.
+template <alphabet A = alphabet::standard>
+class basic_decoding_streambuf : public std::streambuf {
+ public:
+  explicit basic_decoding_streambuf(
+      std::streambuf* source, size_t bufferSize = default_stream_buffer_size)
+      : source_(source),
+        inputsize_(std::max<size_t>(bufferSize / 4, 2) * 4),
+        input_(new char[inputsize_]),
+        output_(new char[inputsize_ / 4 * 3]) {}
+
+  basic_decoding_streambuf(const basic_decoding_streambuf&) = delete;
+  basic_decoding_streambuf& operator=(const basic_decoding_streambuf&) =
+      delete;
+
+ protected:
+  int_type underflow() override {
+    while (gptr() == egptr()) {
+      if (eof_) {
+        return traits_type::eof();
+      }
+      const size_t size =
+          carried_ +
+          static_cast<size_t>(source_->sgetn(
+              input_.get() + carried_,
+              static_cast<std::streamsize>(inputsize_ - carried_)));
+      eof_ = size < inputsize_;
+
+      // The last group is held back until the end of the input is known, as
+      // only the final group may be padded.
+      size_t decoded = 0;
+      size_t consumed = 0;
+      if (eof_) {
+        const std::string_view base64Text(input_.get(), size);
+        const size_t numPadding = detail::count_padding<A>(base64Text);
+        detail::decode<A>(base64Text, numPadding, output_.get());
+        decoded = detail::decoded_size(size, numPadding);
+        consumed = size;
+      } else {
+        const size_t quanta = (size - 1) / 4;
+        if (!detail::decode_quanta<A>(
+                reinterpret_cast<const uint8_t*>(input_.get()), quanta,
+                output_.get())) {
+          detail::record_error(decode_error::invalid_character);
+          throw std::runtime_error{
+              "Invalid base64 encoded data - Invalid character"};
+        }
+        decoded = quanta * 3;
+        consumed = quanta * 4;
+      }
+      carried_ = size - consumed;
+      std::memmove(input_.get(), input_.get() + consumed, carried_);
+      setg(output_.get(), output_.get(), output_.get() + decoded);
+    }
+    return traits_type::to_int_type(*gptr());
+  }
+
+ private:
+  std::streambuf* source_;
+  const size_t inputsize_;
+  std::unique_ptr<char[]> input_;
+  std::unique_ptr<char[]> output_;
+  size_t carried_ = 0;
+  bool eof_ = false;
+};
+
+typedef basic_encoding_streambuf<alphabet::standard> encoding_streambuf;
+typedef basic_decoding_streambuf<alphabet::standard> decoding_streambuf;
+
+}  // namespace base64
+
+#endif  // BASE64_STREAM_HPP_
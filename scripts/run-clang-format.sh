@@ -1,3 +1,4 @@
 #!/usr/bin/env sh
 clang-format -style=Google -i include/*.hpp
 clang-format -style=Google -i test/*.cpp
+clang-format -style=Google -i tools/*.cpp
@@ -0,0 +1,27 @@
+#!/usr/bin/env sh
+# Compares the throughput of the bundled base64 tool with the system one.
+# Usage: scripts/run-cli-benchmark.sh path/to/built/base64 [size in MiB]
+set -eu
+
+cli="$1"
+size_mib="${2:-256}"
+tmp="$(mktemp -d)"
+trap 'rm -rf "$tmp"' EXIT
+
+head -c "$((size_mib * 1024 * 1024))" /dev/urandom > "$tmp/in"
+base64 "$tmp/in" > "$tmp/enc"
+
+run() {
+  printf '%-40s' "$*"
+  start=$(date +%s.%N)
+  "$@" > /dev/null
+  end=$(date +%s.%N)
+  echo "$start $end $size_mib" | awk '{ printf "%8.1f MiB/s\n", $3 / ($2 - $1) }'
+}
+
+run base64 "$tmp/in"
+run "$cli" "$tmp/in"
+run "$cli" -t 4 "$tmp/in"
+run base64 -d "$tmp/enc"
+run "$cli" -d "$tmp/enc"
+run "$cli" -d -t 4 "$tmp/enc"
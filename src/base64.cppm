@@ -0,0 +1,41 @@
+// C++20 module interface for the base64 library. Built by the base64_module
+// target when BASE64_BUILD_MODULE is enabled.
+module;
+
+#include "../include/base64.hpp"
+
+export module base64;
+
+export namespace base64 {
+
+using base64::alphabet;
+using base64::decode_error;
+using base64::padding;
+using base64::validation;
+
+using base64::basic_decoded_view;
+using base64::append_decoded;
+using base64::append_encoded;
+using base64::decode;
+using base64::decode_in_place;
+using base64::decode_into;
+using base64::decoded_url_view;
+using base64::decoded_view;
+using base64::encode;
+using base64::encode_in_place;
+using base64::encode_into;
+using base64::encode_segments_into;
+using base64::encoded_size;
+using base64::equals;
+using base64::equals_constant_time;
+using base64::from_base64;
+using base64::from_base64url;
+using base64::is_contiguous_iterator;
+using base64::non_temporal_threshold;
+using base64::output_buffer_traits;
+using base64::set_non_temporal_threshold;
+using base64::to_base64;
+using base64::to_base64url;
+using base64::transcode;
+
+}  // namespace base64
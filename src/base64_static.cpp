@@ -0,0 +1,27 @@
+// Explicit instantiations of the functions declared in base64_decl.hpp for
+// the base64_static library.
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../include/base64.hpp"
+
+namespace base64 {
+
+#define BASE64_INSTANTIATE(OutputBuffer, A)                                  \
+  template OutputBuffer encode_into<OutputBuffer, A>(std::string_view);     \
+  template OutputBuffer decode_into<OutputBuffer, A>(std::string_view);
+
+BASE64_INSTANTIATE(std::string, alphabet::standard)
+BASE64_INSTANTIATE(std::string, alphabet::url)
+BASE64_INSTANTIATE(std::vector<std::uint8_t>, alphabet::standard)
+BASE64_INSTANTIATE(std::vector<std::uint8_t>, alphabet::url)
+BASE64_INSTANTIATE(std::vector<std::byte>, alphabet::standard)
+BASE64_INSTANTIATE(std::vector<std::byte>, alphabet::url)
+
+#undef BASE64_INSTANTIATE
+
+}  // namespace base64
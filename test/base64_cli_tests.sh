@@ -0,0 +1,62 @@
+#!/usr/bin/env sh
+# Round-trips data through the base64 command-line tool and, where available,
+# compares its output with the coreutils implementation.
+set -eu
+
+cli="$1"
+tmp="$(mktemp -d)"
+trap 'rm -rf "$tmp"' EXIT
+
+for size in 0 1 2 3 56 57 58 1000 100000; do
+  head -c "$size" /dev/urandom > "$tmp/in"
+
+  for threads in 1 3; do
+    "$cli" -t "$threads" "$tmp/in" > "$tmp/enc"
+    "$cli" -d -t "$threads" "$tmp/enc" > "$tmp/dec"
+    cmp "$tmp/in" "$tmp/dec"
+
+    "$cli" -t "$threads" -w 0 --url < "$tmp/in" > "$tmp/enc"
+    "$cli" -d -t "$threads" --url < "$tmp/enc" > "$tmp/dec"
+    cmp "$tmp/in" "$tmp/dec"
+  done
+
+  if command -v base64 > /dev/null 2>&1 &&
+     base64 -w 10 /dev/null > /dev/null 2>&1; then
+    for wrap in 0 4 10 76; do
+      base64 -w "$wrap" "$tmp/in" > "$tmp/expected"
+      "$cli" -w "$wrap" "$tmp/in" > "$tmp/enc"
+      cmp "$tmp/expected" "$tmp/enc"
+    done
+  fi
+done
+
+# Lines that split groups, decoded by several threads.
+head -c 100000 /dev/urandom > "$tmp/in"
+"$cli" -w 5 "$tmp/in" > "$tmp/enc"
+"$cli" -d -t 3 "$tmp/enc" > "$tmp/dec"
+cmp "$tmp/in" "$tmp/dec"
+
+for wrap in -5 +5 ' 5' 5x ''; do
+  if "$cli" -w "$wrap" "$tmp/in" > /dev/null 2>&1; then
+    echo "Wrap size '$wrap' should be rejected"
+    exit 1
+  fi
+done
+
+if printf 'bG8=SGVs' | "$cli" -d > /dev/null 2>&1; then
+  echo "Decoding data after padding should fail"
+  exit 1
+fi
+
+printf 'SGVs\nbG8=\n' | "$cli" -d > "$tmp/dec"
+printf 'Hello' | cmp - "$tmp/dec"
+
+printf 'SG*Vs!bG8=' | "$cli" -d -i > "$tmp/dec"
+printf 'Hello' | cmp - "$tmp/dec"
+
+if printf 'SG*Vs!bG8=' | "$cli" -d > /dev/null 2>&1; then
+  echo "Decoding garbage without --ignore-garbage should fail"
+  exit 1
+fi
+
+echo "All command-line tests passed"
@@ -3,10 +3,33 @@
 
 #include <array>
 #include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <iterator>
+#include <list>
+#include <memory>
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#endif
 #include <string>
+#include <thread>
 #include <vector>
 
+#include "../include/base16.hpp"
+#include "../include/base32.hpp"
 #include "../include/base64.hpp"
+#include "../include/base64_batch.hpp"
+#include "../include/base64_cache.hpp"
+#include "../include/base64_chain.hpp"
+#include "../include/base64_checksum.hpp"
+#include "../include/base64_file.hpp"
+#include "../include/base64_scan.hpp"
+#include "../include/base64_stream.hpp"
+#include "test_bytes.hpp"
 
 // NOLINTNEXTLINE
 TEST(Base64Encode, EncodesEmpty) {
@@ -441,6 +464,1120 @@ TEST(Base64RoundTripTests, TypeMixTests) {
   }
 }
 
+// NOLINTNEXTLINE
+TEST(Base64InPlaceTests, EncodesStringInPlace) {
+  for (std::size_t length = 0; length <= 64; ++length) {
+    std::string buffer = make_test_bytes(length);
+    auto const expected = base64::to_base64(buffer);
+    base64::encode_in_place(buffer);
+    ASSERT_EQ(buffer, expected);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(Base64InPlaceTests, DecodesStringInPlace) {
+  for (std::size_t length = 0; length <= 64; ++length) {
+    std::string const original = make_test_bytes(length);
+    std::string buffer = base64::to_base64(original);
+    base64::decode_in_place(buffer);
+    ASSERT_EQ(buffer, original);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(Base64InPlaceTests, RoundTripsVectorInPlace) {
+  std::vector<std::uint8_t> const original{0x54, 0x68, 0x65, 0x20, 0x71};
+  std::vector<std::uint8_t> buffer = original;
+  base64::encode_in_place(buffer);
+  ASSERT_EQ(std::string(buffer.begin(), buffer.end()), "VGhlIHE=");
+  base64::decode_in_place(buffer);
+  ASSERT_EQ(buffer, original);
+}
+
+// NOLINTNEXTLINE
+TEST(Base64InPlaceTests, EncodesRawBufferInPlace) {
+  std::array<char, 8> buffer{'H', 'e', 'l', 'l', 'o'};
+  ASSERT_THROW(base64::encode_in_place(buffer.data(), 5, 7), std::length_error);
+  auto const size = base64::encode_in_place(buffer.data(), 5, buffer.size());
+  ASSERT_EQ(std::string(buffer.data(), size), "SGVsbG8=");
+  auto const decodedsize = base64::decode_in_place(buffer.data(), size);
+  ASSERT_EQ(std::string(buffer.data(), decodedsize), "Hello");
+}
+
+// NOLINTNEXTLINE
+TEST(Base64InPlaceTests, FailsDecodeInPlace) {
+  std::string size_error{"AAA"};
+  ASSERT_THROW(base64::decode_in_place(size_error), std::runtime_error);
+  std::string char_error{"AA~A"};
+  ASSERT_THROW(base64::decode_in_place(char_error), std::runtime_error);
+  std::string padding_error{"A==="};
+  ASSERT_THROW(base64::decode_in_place(padding_error), std::runtime_error);
+}
+
+// NOLINTNEXTLINE
+TEST(Base64UrlTests, EncodesUrlAlphabet) {
+  std::array<std::uint8_t, 6> const input{0xFB, 0xFF, 0xBF, 0xFE, 0xE9, 0x72};
+  auto const standard{
+      base64::encode_into<std::string>(begin(input), end(input))};
+  auto const url{base64::encode_into<std::string, base64::alphabet::url>(
+      begin(input), end(input))};
+  ASSERT_EQ(standard, "+/+//uly");
+  ASSERT_EQ(url, "-_-__uly");
+  ASSERT_EQ(base64::to_base64url("\xFB\xFF"), "-_8=");
+}
+
+// NOLINTNEXTLINE
+TEST(Base64UrlTests, DecodesPaddedAndUnpadded) {
+  ASSERT_EQ(base64::from_base64url("-_-__uly"), "\xFB\xFF\xBF\xFE\xE9\x72");
+  ASSERT_EQ(base64::from_base64url("-_8="), "\xFB\xFF");
+  ASSERT_EQ(base64::from_base64url("-_8"), "\xFB\xFF");
+  ASSERT_EQ(base64::from_base64url("-w"), "\xFB");
+  ASSERT_EQ(base64::from_base64url("eyJuYW1lIjoiSm9obiBEb2UifQ"),
+            R"({"name":"John Doe"})");
+  ASSERT_THROW(base64::from_base64url("-_8=A"), std::runtime_error);
+  ASSERT_THROW(base64::from_base64url("+/8="), std::runtime_error);
+  ASSERT_THROW(base64::from_base64("-_8="), std::runtime_error);
+}
+
+namespace {
+
+std::string read_file(const std::filesystem::path& path) {
+  std::ifstream in(path, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(in), {});
+}
+
+void write_file(const std::filesystem::path& path, const std::string& data) {
+  std::ofstream out(path, std::ios::binary);
+  out << data;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(Base64FileTests, EncodesAndDecodesFiles) {
+  auto const dir = std::filesystem::temp_directory_path();
+  auto const plain = (dir / "base64_file_test.bin").string();
+  auto const encoded = (dir / "base64_file_test.b64").string();
+  auto const decoded = (dir / "base64_file_test.out").string();
+
+  base64::pipeline_options options;
+  options.block_size = 60;
+  options.buffers = 3;
+  for (std::size_t length : {0, 1, 59, 60, 61, 120, 1000}) {
+    std::string const original = make_test_bytes(length);
+    write_file(plain, original);
+
+    ASSERT_EQ(base64::encode_file(plain, encoded, options),
+              base64::encoded_size(length));
+    ASSERT_EQ(read_file(encoded), base64::to_base64(original));
+    ASSERT_EQ(base64::decode_file(encoded, decoded, options), length);
+    ASSERT_EQ(read_file(decoded), original);
+  }
+
+  write_file(encoded, std::string(120, 'A') + "AA==" + std::string(56, 'A'));
+  ASSERT_THROW(base64::decode_file(encoded, decoded, options),
+               std::runtime_error);
+  write_file(encoded, std::string(120, 'A') + "A~AA");
+  ASSERT_THROW(base64::decode_file(encoded, decoded, options),
+               std::runtime_error);
+  ASSERT_THROW(base64::encode_file(
+                   (dir / "base64_file_test.missing").string(), encoded),
+               std::system_error);
+
+  std::remove(plain.c_str());
+  std::remove(encoded.c_str());
+  std::remove(decoded.c_str());
+}
+
+namespace {
+
+// Output container that is allocated without initializing its elements.
+struct raw_buffer {
+  typedef char value_type;
+  std::unique_ptr<char[]> data;
+  std::size_t size = 0;
+};
+
+}  // namespace
+
+namespace base64 {
+template <>
+struct output_buffer_traits<raw_buffer> {
+  template <class Writer>
+  static raw_buffer create(std::size_t size, Writer&& writer) {
+    raw_buffer buffer{std::unique_ptr<char[]>(new char[size]), size};
+    writer(buffer.data.get());
+    return buffer;
+  }
+};
+}  // namespace base64
+
+// NOLINTNEXTLINE
+TEST(Base64OutputBufferTests, UsesOutputBufferTraits) {
+  auto const encoded = base64::encode_into<raw_buffer>("Hello");
+  ASSERT_EQ(std::string(encoded.data.get(), encoded.size), "SGVsbG8=");
+  auto const decoded = base64::decode_into<raw_buffer>("SGVsbG8=");
+  ASSERT_EQ(std::string(decoded.data.get(), decoded.size), "Hello");
+}
+
+// NOLINTNEXTLINE
+TEST(Base64OutputBufferTests, DecodesIntoByteVector) {
+  auto const decoded = base64::decode_into<std::vector<std::byte>>("AP8=");
+  std::vector<std::byte> const expected{std::byte{0x00}, std::byte{0xFF}};
+  ASSERT_EQ(decoded, expected);
+}
+
+// NOLINTNEXTLINE
+TEST(Base64AllocatorTests, UsesGivenAllocator) {
+  std::string const input{"Hello, World!"};
+  std::allocator<std::uint8_t> const alloc;
+  auto const encoded = base64::encode_into<std::vector<std::uint8_t>>(
+      input.begin(), input.end(), alloc);
+  ASSERT_EQ(std::string(encoded.begin(), encoded.end()),
+            "SGVsbG8sIFdvcmxkIQ==");
+  auto const decoded =
+      base64::decode_into<std::vector<std::uint8_t>>("SGVsbG8sIFdvcmxkIQ==",
+                                                     alloc);
+  ASSERT_EQ(std::string(decoded.begin(), decoded.end()), input);
+}
+
+#if defined(__cpp_lib_memory_resource)
+// NOLINTNEXTLINE
+TEST(Base64AllocatorTests, UsesMemoryResource) {
+  // The arena cannot fall back to the heap, so every allocation has to come
+  // from `storage`.
+  std::array<std::byte, 1024> storage;
+  std::pmr::monotonic_buffer_resource arena(
+      storage.data(), storage.size(), std::pmr::null_memory_resource());
+
+  std::string const input(100, 'x');
+  auto const encoded = base64::encode_into<std::pmr::string>(input, &arena);
+  ASSERT_EQ(std::string_view(encoded), base64::to_base64(input));
+  ASSERT_EQ(encoded.get_allocator().resource(), &arena);
+
+  auto const decoded =
+      base64::decode_into<std::pmr::vector<std::byte>>(encoded, &arena);
+  ASSERT_EQ(decoded.size(), input.size());
+  ASSERT_EQ(decoded.front(), std::byte{'x'});
+  ASSERT_EQ(decoded.get_allocator().resource(), &arena);
+
+  auto const empty =
+      base64::decode_into<std::pmr::string>(std::string_view{}, &arena);
+  ASSERT_TRUE(empty.empty());
+  ASSERT_EQ(empty.get_allocator().resource(), &arena);
+}
+#endif
+
+// NOLINTNEXTLINE
+TEST(Base64StreamTests, EncodesThroughStreambuf) {
+  std::string const original = make_test_bytes(1000);
+
+  std::ostringstream sink;
+  {
+    base64::encoding_streambuf buf(sink.rdbuf(), 16);
+    std::ostream out(&buf);
+    out.put(original[0]);
+    out.write(original.data() + 1, 4);
+    out.flush();
+    out.write(original.data() + 5, 100);
+    for (std::size_t i = 105; i < 200; ++i) {
+      out << original[i];
+    }
+    out.write(original.data() + 200, 800);
+  }
+  ASSERT_EQ(sink.str(), base64::to_base64(original));
+
+  std::ostringstream padded;
+  base64::encoding_streambuf buf(padded.rdbuf());
+  std::ostream out(&buf);
+  out << "Hello";
+  out.flush();
+  ASSERT_EQ(padded.str(), "SGVs");
+  ASSERT_TRUE(buf.close());
+  ASSERT_EQ(padded.str(), "SGVsbG8=");
+  out << "x";
+  ASSERT_TRUE(out.bad());
+}
+
+// NOLINTNEXTLINE
+TEST(Base64StreamTests, DecodesThroughStreambuf) {
+  std::string const original = make_test_bytes(1000);
+
+  for (std::size_t length : {0, 1, 2, 3, 4, 5, 6, 7, 12, 13, 999, 1000}) {
+    std::istringstream source(base64::to_base64(original.substr(0, length)));
+    base64::decoding_streambuf buf(source.rdbuf(), 8);
+    std::istream in(&buf);
+    std::string const decoded(std::istreambuf_iterator<char>(in), {});
+    ASSERT_EQ(decoded, original.substr(0, length));
+  }
+
+  std::istringstream url_source("-_8");
+  base64::basic_decoding_streambuf<base64::alphabet::url> url_buf(
+      url_source.rdbuf());
+  std::istream url_in(&url_buf);
+  ASSERT_EQ(std::string(std::istreambuf_iterator<char>(url_in), {}),
+            "\xFB\xFF");
+
+  for (std::string const invalid :
+       {"AAAAAAA~AAAAAAAA", "AAAA=AAAAAAAAAAA", "AAAAAAAAAA"}) {
+    std::istringstream source(invalid);
+    base64::decoding_streambuf buf(source.rdbuf(), 8);
+    std::istream in(&buf);
+    std::string decoded;
+    in >> decoded;
+    ASSERT_TRUE(in.bad());
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(Base64FixedSizeTests, EncodesFixedSizes) {
+  std::array<std::byte, 16> uuid;
+  std::array<std::uint8_t, 32> digest;
+  std::array<char, 5> hello{'H', 'e', 'l', 'l', 'o'};
+  std::memcpy(digest.data(), make_test_bytes(digest.size()).data(),
+              digest.size());
+  std::memcpy(uuid.data(), digest.data(), uuid.size());
+
+  auto const encoded_uuid = base64::encode<16>(uuid);
+  static_assert(sizeof(encoded_uuid) == 24);
+  ASSERT_EQ(std::string(encoded_uuid.begin(), encoded_uuid.end()),
+            base64::encode_into<std::string>(begin(digest), begin(digest) + 16));
+
+  auto const encoded_digest = base64::encode(digest);
+  static_assert(sizeof(encoded_digest) == 44);
+  ASSERT_EQ(std::string(encoded_digest.begin(), encoded_digest.end()),
+            base64::encode_into<std::string>(begin(digest), end(digest)));
+
+  auto const encoded_hello = base64::encode(hello);
+  ASSERT_EQ(std::string(encoded_hello.begin(), encoded_hello.end()),
+            "SGVsbG8=");
+
+  auto const encoded_url = base64::encode<2, base64::alphabet::url>(
+      std::array<std::uint8_t, 2>{0xFB, 0xFF});
+  ASSERT_EQ(std::string(encoded_url.begin(), encoded_url.end()), "-_8=");
+}
+
+// NOLINTNEXTLINE
+TEST(Base64FixedSizeTests, DecodesFixedSizes) {
+  std::array<std::uint8_t, 32> digest;
+  std::memcpy(digest.data(), make_test_bytes(digest.size()).data(),
+              digest.size());
+  auto const encoded = base64::encode(digest);
+  auto const decoded = base64::decode<32>(encoded);
+  ASSERT_EQ(std::memcmp(decoded.data(), digest.data(), digest.size()), 0);
+
+  auto const hello = base64::decode<5>("SGVsbG8=");
+  ASSERT_EQ(std::memcmp(hello.data(), "Hello", 5), 0);
+  auto const url = base64::decode<2, base64::alphabet::url>("-_8");
+  ASSERT_EQ(url[0], std::byte{0xFB});
+  ASSERT_EQ(url[1], std::byte{0xFF});
+
+  std::string_view const text{"SGVsbG8="};
+  ASSERT_EQ(base64::decode<5>(text)[4], std::byte{'o'});
+  ASSERT_THROW(base64::decode<4>(text), std::runtime_error);
+  ASSERT_THROW(base64::decode<5>(std::string_view{"SGVsbG8A"}),
+               std::runtime_error);
+  ASSERT_THROW(base64::decode<5>("SGVs~G8="), std::runtime_error);
+  ASSERT_THROW(base64::decode<6>("SGVsbG=A"), std::runtime_error);
+}
+
+// NOLINTNEXTLINE
+TEST(Base64IteratorTests, DetectsContiguousIterators) {
+  static_assert(
+      base64::is_contiguous_iterator<std::vector<std::uint8_t>::iterator>());
+  static_assert(
+      base64::is_contiguous_iterator<std::string::const_iterator>());
+  static_assert(base64::is_contiguous_iterator<const std::byte*>());
+  static_assert(!base64::is_contiguous_iterator<std::deque<char>::iterator>());
+  static_assert(!base64::is_contiguous_iterator<std::list<char>::iterator>());
+}
+
+// NOLINTNEXTLINE
+TEST(Base64IteratorTests, EncodesNonContiguousRanges) {
+  std::string const data = make_test_bytes(2000);
+  for (std::size_t size : {0, 1, 2, 3, 767, 768, 769, 2000}) {
+    std::string const expected =
+        base64::to_base64(std::string_view(data.data(), size));
+    std::deque<std::uint8_t> const bytes(data.begin(), data.begin() + size);
+    ASSERT_EQ(base64::encode_into<std::string>(bytes.begin(), bytes.end()),
+              expected);
+    std::list<char> const chars(data.begin(), data.begin() + size);
+    ASSERT_EQ(base64::encode_into<std::string>(chars.begin(), chars.end()),
+              expected);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(Base64IteratorTests, DecodesNonContiguousRanges) {
+  std::string const data = make_test_bytes(2000);
+  for (std::size_t size : {0, 1, 2, 3, 767, 768, 769, 2000}) {
+    std::string const encoded =
+        base64::to_base64(std::string_view(data.data(), size));
+    std::deque<char> const chars(encoded.begin(), encoded.end());
+    ASSERT_EQ(base64::decode_into<std::string>(chars.begin(), chars.end()),
+              data.substr(0, size));
+    std::list<std::uint8_t> const bytes(encoded.begin(), encoded.end());
+    auto const decoded = base64::decode_into<std::vector<std::uint8_t>>(
+        bytes.begin(), bytes.end());
+    ASSERT_EQ(std::string(decoded.begin(), decoded.end()),
+              data.substr(0, size));
+  }
+
+  std::string const url = base64::to_base64url(data.substr(0, 1000));
+  std::deque<char> unpadded(url.begin(), url.end() - 2);
+  ASSERT_EQ((base64::decode_into<std::string, base64::alphabet::url>(
+                unpadded.begin(), unpadded.end())),
+            data.substr(0, 1000));
+}
+
+// NOLINTNEXTLINE
+TEST(Base64IteratorTests, RejectsInvalidNonContiguousRanges) {
+  std::string encoded = base64::to_base64(std::string(1500, 'x'));
+  std::deque<char> chars(encoded.begin(), encoded.end());
+  chars[5] = '*';
+  ASSERT_THROW(base64::decode_into<std::string>(chars.begin(), chars.end()),
+               std::runtime_error);
+  chars.assign(encoded.begin(), encoded.end());
+  chars[chars.size() - 3] = '=';
+  ASSERT_THROW(base64::decode_into<std::string>(chars.begin(), chars.end()),
+               std::runtime_error);
+  chars.pop_back();
+  ASSERT_THROW(base64::decode_into<std::string>(chars.begin(), chars.end()),
+               std::runtime_error);
+}
+
+// NOLINTNEXTLINE
+TEST(Base64ScanTests, FindsAndDecodesRuns) {
+  std::string const payload(100, 'x');
+  std::string const encoded = base64::to_base64(payload);
+  std::string const text = "{\"id\": 12, \"blob\": \"" + encoded +
+                           "\", \"hello\": \"SGVsbG8=\", \"tail\": \"" +
+                           encoded.substr(0, 40) + "\"}";
+
+  std::vector<std::string> decoded;
+  auto const matches = base64::scan(
+      text,
+      [&](const base64::scan_match& match, std::string_view bytes) {
+        ASSERT_EQ(match.size % 4, 0);
+        decoded.emplace_back(bytes);
+      },
+      base64::scan_options{8});
+  ASSERT_EQ(matches.size(), 3);
+  ASSERT_EQ(text.substr(matches[0].offset, matches[0].size), encoded);
+  ASSERT_EQ(decoded[0], payload);
+  ASSERT_EQ(text.substr(matches[1].offset, matches[1].size), "SGVsbG8=");
+  ASSERT_EQ(decoded[1], "Hello");
+  ASSERT_EQ(decoded[2], payload.substr(0, 30));
+
+  ASSERT_EQ(base64::find_runs(text).size(), 2);
+  ASSERT_TRUE(base64::find_runs("no base64 in here", {}).empty());
+}
+
+// NOLINTNEXTLINE
+TEST(Base64ScanTests, EndsRunsAtWholeGroups) {
+  // "Hello" without padding is only a run up to its last whole group, unless
+  // the url alphabet is used.
+  std::string const text = "<SGVsbG8> <SGVsbG8==> <abc=>";
+  std::vector<std::string> decoded;
+  auto const sink = [&](const base64::scan_match&, std::string_view bytes) {
+    decoded.emplace_back(bytes);
+  };
+  auto matches = base64::scan(text, sink, base64::scan_options{1});
+  ASSERT_EQ(matches.size(), 3);
+  ASSERT_EQ(matches[0].size, 4);
+  ASSERT_EQ(decoded[0], "Hel");
+  ASSERT_EQ(matches[1].size, 4);
+  ASSERT_EQ(matches[2].size, 4);
+  ASSERT_EQ(decoded[2], std::string("i\xB7", 2));
+
+  decoded.clear();
+  matches = base64::scan<base64::alphabet::url>(text, sink,
+                                                base64::scan_options{1});
+  ASSERT_EQ(matches[0].size, 7);
+  ASSERT_EQ(decoded[0], "Hello");
+}
+
+// NOLINTNEXTLINE
+TEST(Base64ScanTests, FindsDataUris) {
+  std::string const image(300, '\x89');
+  std::string const encoded = base64::to_base64(image);
+  std::string const text =
+      "body { background: url(data:image/png;BASE64," + encoded +
+      "); }\n<a href=\"data:text/plain,SGVsbG8=\">QUJDRA==</a>" +
+      "<img src='data:image/gif;charset=x;base64,R0lGODlh'>";
+
+  std::vector<std::string> decoded;
+  auto const matches = base64::scan(
+      text,
+      [&](const base64::scan_match&, std::string_view bytes) {
+        decoded.emplace_back(bytes);
+      },
+      base64::scan_options{0, true});
+  ASSERT_EQ(matches.size(), 2);
+  ASSERT_EQ(text.substr(matches[0].offset, matches[0].size), encoded);
+  ASSERT_EQ(decoded[0], image);
+  ASSERT_EQ(decoded[1], "GIF89a");
+}
+
+// NOLINTNEXTLINE
+TEST(Base64ChecksumTests, ComputesKnownChecksums) {
+  base64::crc32c crc;
+  crc.update("123456789", 9);
+  ASSERT_EQ(crc.value(), 0xE3069283);
+  ASSERT_EQ(base64::crc32c().value(), 0);
+
+  ASSERT_EQ(base64::xxhash64().value(), 0xEF46DB3751D8E999);
+  base64::xxhash64 xxh;
+  xxh.update("abc", 3);
+  ASSERT_EQ(xxh.value(), 0x44BC2CF5AD770999);
+
+  // Hardware and software CRC-32C and any split of the input agree.
+  std::string const data = make_test_bytes(1000);
+  base64::crc32c whole_crc;
+  base64::xxhash64 whole_xxh(42);
+  whole_crc.update(data.data(), data.size());
+  whole_xxh.update(data.data(), data.size());
+  ASSERT_EQ(whole_crc.value(),
+            ~base64::detail::crc32c_software(
+                0xFFFFFFFF, reinterpret_cast<const std::uint8_t*>(data.data()),
+                data.size()) &
+                0xFFFFFFFF);
+  for (std::size_t split : {1, 7, 31, 32, 33, 500}) {
+    base64::crc32c split_crc;
+    base64::xxhash64 split_xxh(42);
+    for (std::size_t pos = 0; pos < data.size(); pos += split) {
+      std::size_t const count = std::min(split, data.size() - pos);
+      split_crc.update(data.data() + pos, count);
+      split_xxh.update(data.data() + pos, count);
+    }
+    ASSERT_EQ(split_crc.value(), whole_crc.value());
+    ASSERT_EQ(split_xxh.value(), whole_xxh.value());
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(Base64ChecksumTests, EncodesAndDecodesWithChecksum) {
+  std::string const data = make_test_bytes(40000);
+  for (std::size_t size : {0, 1, 2, 12288, 12289, 40000}) {
+    std::string_view const input(data.data(), size);
+    base64::crc32c crc;
+    crc.update(input.data(), input.size());
+    base64::xxhash64 xxh;
+    xxh.update(input.data(), input.size());
+
+    auto const encoded = base64::encode_into_with_checksum<std::string>(input);
+    ASSERT_EQ(encoded.output, base64::to_base64(input));
+    ASSERT_EQ(encoded.checksum, crc.value());
+
+    auto const decoded = base64::decode_into_with_checksum<
+        std::vector<std::uint8_t>, base64::xxhash64>(encoded.output);
+    ASSERT_EQ(std::string(decoded.output.begin(), decoded.output.end()),
+              input);
+    ASSERT_EQ(decoded.checksum, xxh.value());
+  }
+
+  std::string encoded = base64::to_base64(data);
+  encoded[100] = '=';
+  ASSERT_THROW(base64::decode_into_with_checksum<std::string>(encoded),
+               std::runtime_error);
+}
+
+// NOLINTNEXTLINE
+TEST(Base64TranscodeTests, ConvertsBetweenAlphabets) {
+  using base64::alphabet;
+  std::string const data = make_test_bytes(300);
+  for (std::size_t size : {0, 1, 2, 3, 100, 299, 300}) {
+    std::string_view const input(data.data(), size);
+    std::string const standard = base64::to_base64(input);
+    std::string const url = base64::to_base64url(input);
+    std::string unpadded = url;
+    unpadded.erase(std::min(unpadded.find('='), unpadded.size()));
+
+    ASSERT_EQ((base64::transcode<alphabet::standard, alphabet::url>(standard)),
+              url);
+    ASSERT_EQ((base64::transcode<alphabet::standard, alphabet::url>(
+                  standard, base64::padding::unpadded)),
+              unpadded);
+    ASSERT_EQ((base64::transcode<alphabet::url, alphabet::standard>(url)),
+              standard);
+    ASSERT_EQ((base64::transcode<alphabet::url, alphabet::standard>(unpadded)),
+              standard);
+    ASSERT_EQ((base64::transcode<alphabet::url, alphabet::url>(
+                  unpadded, base64::padding::padded)),
+              url);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(Base64TranscodeTests, ValidatesSource) {
+  using base64::alphabet;
+  auto const to_url = [](std::string_view text) {
+    return base64::transcode<alphabet::standard, alphabet::url>(text);
+  };
+  auto const to_standard = [](std::string_view text) {
+    return base64::transcode<alphabet::url, alphabet::standard>(text);
+  };
+  ASSERT_EQ(to_url("+/+/"), "-_-_");
+  ASSERT_THROW(to_url("-_-_"), std::runtime_error);
+  ASSERT_THROW(to_url("ab c"), std::runtime_error);
+  ASSERT_THROW(to_url("abc"), std::runtime_error);
+  ASSERT_THROW(to_url("a==="), std::runtime_error);
+  ASSERT_THROW(to_url("a=bc"), std::runtime_error);
+  ASSERT_THROW(to_standard("+/+/"), std::runtime_error);
+  ASSERT_THROW(to_standard("abcde"), std::runtime_error);
+  ASSERT_THROW(to_standard("abcdef="), std::runtime_error);
+  ASSERT_THROW(to_standard("=="), std::runtime_error);
+  ASSERT_EQ(to_standard("abcdef=="), "abcdef==");
+  ASSERT_EQ(to_standard("abcdefg"), "abcdefg=");
+}
+
+// NOLINTNEXTLINE
+TEST(Base16Tests, EncodesAndDecodesRfc4648Vectors) {
+  ASSERT_EQ(base16::to_base16(""), "");
+  ASSERT_EQ(base16::to_base16("f"), "66");
+  ASSERT_EQ(base16::to_base16("foobar"), "666F6F626172");
+  ASSERT_EQ(base16::to_base16_lower("\xDE\xAD\xBE\xEF"), "deadbeef");
+  ASSERT_EQ(base16::from_base16("666F6F626172"), "foobar");
+  ASSERT_EQ(base16::from_base16("deADbeEF"), "\xDE\xAD\xBE\xEF");
+
+  std::deque<std::byte> const bytes{std::byte{0x01}, std::byte{0xFE}};
+  ASSERT_EQ(base16::encode_into<std::string>(bytes.begin(), bytes.end()),
+            "01FE");
+  auto const decoded = base16::decode_into<std::vector<std::uint8_t>>("01fe");
+  ASSERT_EQ(decoded, (std::vector<std::uint8_t>{0x01, 0xFE}));
+
+  ASSERT_THROW(base16::from_base16("666"), std::runtime_error);
+  ASSERT_THROW(base16::from_base16("6G"), std::runtime_error);
+  ASSERT_THROW(base16::from_base16("6 "), std::runtime_error);
+}
+
+// NOLINTNEXTLINE
+TEST(Base32Tests, EncodesAndDecodesRfc4648Vectors) {
+  std::vector<std::pair<std::string, std::string>> const standard{
+      {"", ""},
+      {"f", "MY======"},
+      {"fo", "MZXQ===="},
+      {"foo", "MZXW6==="},
+      {"foob", "MZXW6YQ="},
+      {"fooba", "MZXW6YTB"},
+      {"foobar", "MZXW6YTBOI======"}};
+  std::vector<std::pair<std::string, std::string>> const hex{
+      {"", ""},
+      {"f", "CO======"},
+      {"fo", "CPNG===="},
+      {"foo", "CPNMU==="},
+      {"foob", "CPNMUOG="},
+      {"fooba", "CPNMUOJ1"},
+      {"foobar", "CPNMUOJ1E8======"}};
+  for (auto const& [data, encoded] : standard) {
+    ASSERT_EQ(base32::to_base32(data), encoded);
+    ASSERT_EQ(base32::from_base32(encoded), data);
+    std::string unpadded = encoded;
+    unpadded.erase(std::min(unpadded.find('='), unpadded.size()));
+    ASSERT_EQ(base32::from_base32(unpadded), data);
+  }
+  for (auto const& [data, encoded] : hex) {
+    ASSERT_EQ(base32::to_base32hex(data), encoded);
+    ASSERT_EQ(base32::from_base32hex(encoded), data);
+  }
+  ASSERT_EQ(base32::from_base32("mzxw6ytboi"), "foobar");
+}
+
+// NOLINTNEXTLINE
+TEST(Base32Tests, HandlesLargeAndInvalidInput) {
+  std::string const data = make_test_bytes(3000);
+  std::string const encoded = base32::to_base32(data);
+  ASSERT_EQ(encoded.size(), base32::encoded_size(data.size()));
+  ASSERT_EQ(base32::from_base32(encoded), data);
+  std::list<char> const chars(data.begin(), data.end());
+  ASSERT_EQ(base32::encode_into<std::string>(chars.begin(), chars.end()),
+            encoded);
+
+  ASSERT_THROW(base32::from_base32("MZXW6YTB1"), std::runtime_error);
+  ASSERT_THROW(base32::from_base32("MZX====="), std::runtime_error);
+  ASSERT_THROW(base32::from_base32("M======="), std::runtime_error);
+  ASSERT_THROW(base32::from_base32("MZ=W6YTB"), std::runtime_error);
+  ASSERT_THROW(base32::from_base32("MZXW18==="), std::runtime_error);
+  ASSERT_THROW(base32::from_base32hex("MY======"), std::runtime_error);
+}
+
+namespace {
+
+// Restores the non-temporal threshold when a test returns, also after a
+// failed assertion.
+class threshold_guard {
+ public:
+  threshold_guard() : threshold_(base64::non_temporal_threshold()) {}
+  threshold_guard(const threshold_guard&) = delete;
+  threshold_guard& operator=(const threshold_guard&) = delete;
+  ~threshold_guard() { base64::set_non_temporal_threshold(threshold_); }
+
+  std::size_t threshold() const { return threshold_; }
+
+ private:
+  std::size_t const threshold_;
+};
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(Base64NonTemporalTests, MatchesRegularStores) {
+  std::string const data = make_test_bytes(20000);
+  threshold_guard const guard;
+  ASSERT_GT(guard.threshold(), 0);
+  for (std::size_t size : {3000, 3071, 3072, 3073, 19999, 20000}) {
+    for (std::size_t offset : {0, 1, 5}) {
+      std::string_view const input(data.data() + offset, size - offset);
+      base64::set_non_temporal_threshold(SIZE_MAX);
+      std::string const expected = base64::to_base64(input);
+      base64::set_non_temporal_threshold(1024);
+      ASSERT_EQ(base64::to_base64(input), expected);
+      ASSERT_EQ(base64::from_base64(expected), input);
+      ASSERT_EQ((base64::decode_into<std::string, base64::alphabet::url>(
+                    base64::to_base64url(input))),
+                input);
+    }
+  }
+
+  std::string invalid = base64::to_base64(data);
+  invalid[5000] = '*';
+  ASSERT_THROW(base64::from_base64(invalid), std::runtime_error);
+}
+
+// NOLINTNEXTLINE
+TEST(Base64SmallInputTests, MatchesBulkKernel) {
+  std::string const data = make_test_bytes(80);
+  for (std::size_t size = 0; size <= data.size(); ++size) {
+    std::string_view const input(data.data(), size);
+    // The list is encoded through the staging buffer instead.
+    std::list<char> const chars(input.begin(), input.end());
+    std::string const expected =
+        base64::encode_into<std::string>(chars.begin(), chars.end());
+    ASSERT_EQ(base64::to_base64(input), expected);
+    ASSERT_EQ(base64::from_base64(expected), input);
+
+    std::string url = base64::to_base64url(input);
+    url.erase(std::min(url.find('='), url.size()));
+    ASSERT_EQ(base64::from_base64url(url), input);
+
+    for (std::size_t pos = 0; pos < expected.size(); pos += 7) {
+      std::string invalid = expected;
+      invalid[pos] = '*';
+      ASSERT_THROW(base64::from_base64(invalid), std::runtime_error);
+    }
+  }
+  ASSERT_THROW(base64::from_base64("AB=C"), std::runtime_error);
+  ASSERT_THROW(base64::from_base64("A=A="), std::runtime_error);
+  ASSERT_THROW(base64::from_base64("AA==AAAA"), std::runtime_error);
+}
+
+// NOLINTNEXTLINE
+TEST(Base64SegmentsTests, MatchesConcatenation) {
+  std::string const data = "header\r\n\r\nbody chunk and trailer";
+  for (std::size_t first = 0; first <= data.size(); ++first) {
+    for (std::size_t second = first; second <= data.size(); ++second) {
+      std::vector<std::string_view> const segments = {
+          std::string_view(data).substr(0, first),
+          std::string_view(data).substr(first, second - first),
+          std::string_view(data).substr(second)};
+      ASSERT_EQ(base64::encode_segments_into<std::string>(segments),
+                base64::to_base64(data));
+      ASSERT_EQ(
+          (base64::encode_segments_into<std::string, base64::alphabet::url>(
+              segments)),
+          base64::to_base64url(data));
+    }
+  }
+  ASSERT_EQ(base64::encode_segments_into<std::string>({"f", "o", "o", "ba"}),
+            "Zm9vYmE=");
+  ASSERT_EQ(base64::encode_segments_into<std::string>({"", ""}), "");
+}
+
+// NOLINTNEXTLINE
+TEST(Base64SegmentsTests, AcceptsPointerAndIovecSegments) {
+  struct io_vector {
+    void* iov_base;
+    std::size_t iov_len;
+  };
+  std::array<std::uint8_t, 4> bytes = {0x00, 0x01, 0xFE, 0xFF};
+  std::vector<io_vector> const iov = {{bytes.data(), 1}, {bytes.data() + 1, 3}};
+  ASSERT_EQ(base64::encode_segments_into<std::string>(iov), "AAH+/w==");
+
+  std::vector<std::pair<std::uint8_t const*, std::size_t>> const pairs = {
+      {bytes.data(), 2}, {bytes.data() + 2, 2}};
+  ASSERT_EQ(base64::encode_segments_into<std::vector<std::uint8_t>>(pairs),
+            base64::encode_into<std::vector<std::uint8_t>>(bytes.begin(),
+                                                           bytes.end()));
+}
+
+// NOLINTNEXTLINE
+TEST(Base64ChainTests, FillsEveryBlockBeforeTheNext) {
+  std::string data;
+  for (std::size_t i = 0; i < 100; ++i) {
+    data.push_back(static_cast<char>(i * 13 + 5));
+  }
+  for (std::size_t blockSize = 1; blockSize <= 9; ++blockSize) {
+    for (std::size_t size = 0; size <= data.size(); size += 7) {
+      std::string_view const input(data.data(), size);
+      base64::chunk_chain encoded(blockSize);
+      base64::encode_into_chain(input, encoded);
+      ASSERT_EQ(encoded.str(), base64::to_base64(input));
+      for (std::size_t i = 0; i + 1 < encoded.block_count(); ++i) {
+        ASSERT_EQ(encoded.block(i).size(), blockSize);
+      }
+
+      base64::chunk_chain decoded(blockSize);
+      base64::decode_into_chain(encoded.str(), decoded);
+      ASSERT_EQ(decoded.str(), input);
+
+      std::string url = base64::to_base64url(input);
+      url.erase(std::min(url.find('='), url.size()));
+      base64::chunk_chain urlDecoded(blockSize);
+      base64::decode_into_chain<base64::alphabet::url>(url, urlDecoded);
+      ASSERT_EQ(urlDecoded.str(), input);
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(Base64ChainTests, AppendsAndRejectsInvalidInput) {
+  base64::chunk_chain chain(5);
+  base64::encode_into_chain("foo", chain);
+  base64::encode_into_chain("ba", chain);
+  ASSERT_EQ(chain.str(), "Zm9vYmE=");
+  ASSERT_EQ(chain.block_count(), 2U);
+
+  base64::chunk_chain decoded(4);
+  ASSERT_THROW(base64::decode_into_chain("Zm9v*mE=", decoded),
+               std::runtime_error);
+  ASSERT_THROW(base64::decode_into_chain("Zm9vY", decoded),
+               std::runtime_error);
+  decoded.clear();
+  ASSERT_TRUE(decoded.empty());
+
+  base64::chunk_chain moved(std::move(chain));
+  ASSERT_EQ(moved.str(), "Zm9vYmE=");
+  ASSERT_TRUE(chain.empty());  // NOLINT(bugprone-use-after-move)
+}
+
+#if defined(BASE64_HAS_IOVEC)
+// NOLINTNEXTLINE
+TEST(Base64ChainTests, ExposesBlocksAsIovecs) {
+  base64::chunk_chain chain(6);
+  base64::encode_into_chain("Many hands make light work.", chain);
+  std::vector<iovec> const iov = chain.iovecs();
+  ASSERT_EQ(iov.size(), chain.block_count());
+  std::string joined;
+  for (iovec const& v : iov) {
+    joined.append(static_cast<char const*>(v.iov_base), v.iov_len);
+  }
+  ASSERT_EQ(joined, "TWFueSBoYW5kcyBtYWtlIGxpZ2h0IHdvcmsu");
+}
+#endif
+
+#if defined(__cpp_lib_memory_resource)
+// NOLINTNEXTLINE
+TEST(Base64ChainTests, AllocatesBlocksFromPool) {
+  std::pmr::unsynchronized_pool_resource pool;
+  base64::basic_chunk_chain<std::pmr::polymorphic_allocator<char>> chain(
+      16, &pool);
+  std::string const data(1000, 'x');
+  base64::encode_into_chain(data, chain);
+  ASSERT_EQ(chain.str(), base64::to_base64(data));
+  ASSERT_EQ(chain.block_count(), (base64::encoded_size(data.size()) + 15) / 16);
+
+  std::pmr::monotonic_buffer_resource other;
+  base64::basic_chunk_chain<std::pmr::polymorphic_allocator<char>> copy(
+      16, &other);
+  copy = std::move(chain);
+  ASSERT_EQ(copy.str(), base64::to_base64(data));
+  ASSERT_TRUE(chain.empty());  // NOLINT(bugprone-use-after-move)
+}
+#endif
+
+// NOLINTNEXTLINE
+TEST(Base64DecodedViewTests, ReadsAnyRange) {
+  std::string data = make_test_bytes(50);
+  for (std::size_t size = 0; size <= data.size(); size += 7) {
+    std::string_view const input(data.data(), size);
+    std::string const encoded = base64::to_base64(input);
+    base64::decoded_view const view(encoded);
+    ASSERT_EQ(view.size(), size);
+    for (std::size_t offset = 0; offset <= size; ++offset) {
+      for (std::size_t count = 0; count <= size - offset + 1; ++count) {
+        std::string out(count, '\0');
+        std::size_t const read = view.read(offset, count, out.data());
+        out.resize(read);
+        ASSERT_EQ(out, input.substr(offset, count));
+      }
+    }
+    for (std::size_t i = 0; i < size; ++i) {
+      ASSERT_EQ(view[i], input[i]);
+      ASSERT_EQ(view.at(i), input[i]);
+    }
+    ASSERT_THROW(view.at(size), std::out_of_range);
+    ASSERT_THROW(view.read(size + 1, 1, data.data()), std::out_of_range);
+  }
+
+  std::string url = base64::to_base64url("Many hands make light work");
+  url.erase(url.find('='));
+  base64::decoded_url_view const view(url, base64::validation::eager);
+  std::vector<std::uint8_t> out(5);
+  ASSERT_EQ(view.read(21, 10, out.data()), 5U);
+  ASSERT_EQ(std::string(out.begin(), out.end()), " work");
+}
+
+// NOLINTNEXTLINE
+TEST(Base64DecodedViewTests, ValidatesLazilyOrEagerly) {
+  std::string const encoded = "TWFu*SBoYW5kcw==";
+  base64::decoded_view const lazy(encoded);
+  char out[4];
+  ASSERT_EQ(lazy.read(0, 3, out), 3U);
+  ASSERT_EQ(std::string(out, 3), "Man");
+  ASSERT_EQ(lazy.read(6, 3, out), 3U);
+  ASSERT_EQ(std::string(out, 3), "and");
+  ASSERT_THROW(lazy.read(3, 1, out), std::runtime_error);
+  ASSERT_THROW(base64::decoded_view(encoded, base64::validation::eager),
+               std::runtime_error);
+  ASSERT_THROW(base64::decoded_view("TWF"), std::runtime_error);
+  ASSERT_THROW(base64::decoded_view("T==="), std::runtime_error);
+  ASSERT_THROW(base64::decoded_view("TW=u").read(0, 2, out),
+               std::runtime_error);
+}
+
+// NOLINTNEXTLINE
+TEST(Base64EqualsTests, ComparesDecodedBytes) {
+  std::string const data = make_test_bytes(400);
+  for (std::size_t size = 0; size <= data.size(); size += 13) {
+    std::string_view const input(data.data(), size);
+    std::string const encoded = base64::to_base64(input);
+    ASSERT_TRUE(base64::equals(encoded, input));
+    ASSERT_TRUE(base64::equals_constant_time(encoded, input));
+    for (std::size_t pos = 0; pos < size; pos += 5) {
+      std::string changed(input);
+      changed[pos] = static_cast<char>(changed[pos] ^ 0x40);
+      ASSERT_FALSE(base64::equals(encoded, changed));
+      ASSERT_FALSE(base64::equals_constant_time(encoded, changed));
+    }
+    ASSERT_FALSE(base64::equals(encoded, data.substr(0, size + 1)));
+  }
+
+  std::vector<std::byte> const key = {std::byte{0x00}, std::byte{0x01},
+                                      std::byte{0xFE}, std::byte{0xFF}};
+  ASSERT_TRUE(base64::equals("AAH+/w==", key));
+  ASSERT_TRUE(base64::equals_constant_time("AAH+/w==", key));
+  ASSERT_TRUE(base64::equals<base64::alphabet::url>("AAH-_w", key));
+  ASSERT_FALSE(base64::equals("AAH-_w==", key));
+}
+
+// NOLINTNEXTLINE
+TEST(Base64EqualsTests, RejectsMalformedTextWithoutThrowing) {
+  ASSERT_FALSE(base64::equals("Zm9", "fo"));
+  ASSERT_FALSE(base64::equals("Z===", ""));
+  ASSERT_FALSE(base64::equals("Zm=v", "fo"));
+  ASSERT_FALSE(base64::equals("Zm*v", "foo"));
+  ASSERT_FALSE(base64::equals_constant_time("Zm9v*mE=", "fooba"));
+  ASSERT_FALSE(base64::equals<base64::alphabet::url>("Zm9vY", "foo"));
+  ASSERT_TRUE(base64::equals("", ""));
+  ASSERT_FALSE(base64::equals("", "f"));
+}
+
+// NOLINTNEXTLINE
+TEST(Base64DecodeCacheTests, SharesDecodedBuffers) {
+  base64::decode_cache cache;
+  auto const first = cache.decode("eyJhbGciOiJIUzI1NiJ9");
+  auto const second = cache.decode("eyJhbGciOiJIUzI1NiJ9");
+  ASSERT_EQ(*first, "{\"alg\":\"HS256\"}");
+  ASSERT_EQ(first.get(), second.get());
+  ASSERT_EQ(cache.hits(), 1U);
+  ASSERT_EQ(cache.misses(), 1U);
+  ASSERT_EQ(cache.size(), 1U);
+
+  ASSERT_THROW(cache.decode("eyJh*GciOiJIUzI1NiJ9"), std::runtime_error);
+  ASSERT_EQ(cache.size(), 1U);
+
+  base64::decode_url_cache urlCache;
+  ASSERT_EQ(*urlCache.decode("-_8"), "\xFB\xFF");
+
+  cache.clear();
+  ASSERT_EQ(cache.size(), 0U);
+  ASSERT_EQ(*first, "{\"alg\":\"HS256\"}");
+}
+
+// NOLINTNEXTLINE
+TEST(Base64DecodeCacheTests, EvictsBeyondCapacity) {
+  base64::decode_cache_options options;
+  options.capacity = 8;
+  options.shards = 2;
+  options.max_text_size = 16;
+  base64::decode_cache cache(options);
+  for (int round = 0; round < 3; ++round) {
+    for (int i = 0; i < 100; ++i) {
+      std::string const value = "value " + std::to_string(i);
+      ASSERT_EQ(*cache.decode(base64::to_base64(value)), value);
+      ASSERT_LE(cache.size(), 8U);
+    }
+  }
+  std::string const large(100, 'x');
+  ASSERT_EQ(*cache.decode(base64::to_base64(large)), large);
+  ASSERT_LE(cache.size(), 8U);
+
+  // Repeated lookups of one text keep it cached.
+  cache.clear();
+  std::string const hot = base64::to_base64("hot");
+  cache.decode(hot);
+  for (int i = 0; i < 100; ++i) {
+    cache.decode(hot);
+    cache.decode(base64::to_base64(std::to_string(i)));
+  }
+  std::uint64_t const misses = cache.misses();
+  cache.decode(hot);
+  ASSERT_EQ(cache.misses(), misses);
+}
+
+// NOLINTNEXTLINE
+TEST(Base64DecodeCacheTests, NeverExceedsCapacity) {
+  for (std::size_t capacity : {0, 1, 3, 10, 17}) {
+    base64::decode_cache_options options;
+    options.capacity = capacity;
+    options.shards = 8;
+    base64::decode_cache cache(options);
+    for (int i = 0; i < 200; ++i) {
+      std::string const value = std::to_string(i);
+      ASSERT_EQ(*cache.decode(base64::to_base64(value)), value);
+      ASSERT_LE(cache.size(), capacity);
+    }
+    // Every shard is filled, so the whole capacity ends up used.
+    ASSERT_EQ(cache.size(), capacity);
+  }
+
+  base64::decode_cache_options options;
+  options.capacity = 0;
+  base64::decode_cache disabled(options);
+  std::string const text = base64::to_base64("text");
+  ASSERT_EQ(*disabled.decode(text), "text");
+  ASSERT_EQ(*disabled.decode(text), "text");
+  ASSERT_EQ(disabled.hits(), 0U);
+  ASSERT_EQ(disabled.size(), 0U);
+}
+
+// NOLINTNEXTLINE
+TEST(Base64DecodeCacheTests, IsThreadSafe) {
+  base64::decode_cache_options options;
+  options.capacity = 16;
+  base64::decode_cache cache(options);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&cache, t] {
+      for (int i = 0; i < 2000; ++i) {
+        std::string const value = std::to_string((i * 7 + t) % 40);
+        ASSERT_EQ(*cache.decode(base64::to_base64(value)), value);
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(cache.hits() + cache.misses(), 8000U);
+}
+
+// NOLINTNEXTLINE
+TEST(Base64AppendTests, AppendsToExistingContents) {
+  std::string header = "Authorization: Basic ";
+  base64::append_encoded(header, "user:pass");
+  ASSERT_EQ(header, "Authorization: Basic dXNlcjpwYXNz");
+
+  std::string decoded = "user=";
+  base64::append_decoded(decoded, "dXNlcg==");
+  base64::append_decoded(decoded, "");
+  ASSERT_EQ(decoded, "user=user");
+
+  std::vector<std::uint8_t> bytes = {0x01};
+  base64::append_decoded<base64::alphabet::url>(bytes, "_-8");
+  ASSERT_EQ(bytes, (std::vector<std::uint8_t>{0x01, 0xFF, 0xEF}));
+
+  std::string json = "{\"key\":\"";
+  base64::append_encoded<base64::alphabet::url>(json, bytes);
+  json += "\"}";
+  ASSERT_EQ(json, "{\"key\":\"Af_v\"}");
+
+  for (std::size_t size = 0; size <= 100; ++size) {
+    std::string const data = make_test_bytes(size);
+    std::string out = "prefix";
+    base64::append_encoded(out, data);
+    ASSERT_EQ(out, "prefix" + base64::to_base64(data));
+    std::string back = "prefix";
+    base64::append_decoded(back, out.substr(6));
+    ASSERT_EQ(back, "prefix" + data);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(Base64AppendTests, LeavesContainerUnchangedOnError) {
+  std::string out = "keep";
+  ASSERT_THROW(base64::append_decoded(out, "Zm9v*mE="), std::runtime_error);
+  ASSERT_EQ(out, "keep");
+  ASSERT_THROW(base64::append_decoded(out, "Zm9vY==="), std::runtime_error);
+  ASSERT_THROW(base64::append_decoded(out, "Zm9"), std::runtime_error);
+  ASSERT_EQ(out, "keep");
+
+  std::vector<char> chars = {'k'};
+  ASSERT_THROW(base64::append_decoded(chars, "Zm9vYmF*"), std::runtime_error);
+  ASSERT_EQ(chars, std::vector<char>{'k'});
+}
+
+// NOLINTNEXTLINE
+TEST(Base64BatchTests, MatchesPerMessageResults) {
+  std::string const data = make_test_bytes(300);
+  // Sizes of every remainder modulo 3 and 4, including empty ones.
+  std::vector<std::string> messages;
+  for (std::size_t i = 0; i < 40; ++i) {
+    messages.push_back(data.substr(i, (i * 53) % 260));
+  }
+
+  auto const encoded = base64::encode_batch(messages);
+  auto const url =
+      base64::encode_batch<std::string, base64::alphabet::url>(messages);
+  ASSERT_EQ(encoded.size(), messages.size());
+  std::vector<std::string_view> texts;
+  for (std::size_t i = 0; i < messages.size(); ++i) {
+    ASSERT_EQ(encoded[i], base64::to_base64(messages[i]));
+    ASSERT_EQ(url[i], base64::to_base64url(messages[i]));
+    texts.push_back(encoded[i]);
+  }
+
+  auto const decoded = base64::decode_batch<std::vector<std::uint8_t>>(texts);
+  for (std::size_t i = 0; i < messages.size(); ++i) {
+    ASSERT_FALSE(decoded.errors[i]);
+    ASSERT_EQ(decoded[i], messages[i]);
+  }
+
+  ASSERT_EQ(base64::encode_batch(std::vector<std::string>()).size(), 0U);
+}
+
+// NOLINTNEXTLINE
+TEST(Base64BatchTests, ReportsErrorsPerMessage) {
+  std::vector<std::string_view> const texts = {
+      "Zm9vYmFy", "Zm9",      "Zm9vYmF*",        "Z===",
+      "",         "Zm9vYg==", "Zm9vYmFyYmF6*A=="};
+  auto const decoded = base64::decode_batch(texts);
+  ASSERT_EQ(decoded[0], "foobar");
+  ASSERT_EQ(decoded.errors[1], base64::decode_error::invalid_size);
+  ASSERT_EQ(decoded.errors[2], base64::decode_error::invalid_character);
+  ASSERT_EQ(decoded[2], "");
+  ASSERT_EQ(decoded.errors[3], base64::decode_error::invalid_padding);
+  ASSERT_FALSE(decoded.errors[4]);
+  ASSERT_EQ(decoded[5], "foob");
+  ASSERT_EQ(decoded.errors[6], base64::decode_error::invalid_character);
+
+  std::vector<std::string_view> const url = {"_-8", "Zm9vY", "Zm8"};
+  auto const urlDecoded = base64::decode_batch<std::string,
+                                               base64::alphabet::url>(url);
+  ASSERT_EQ(urlDecoded[0], "\xFF\xEF");
+  ASSERT_EQ(urlDecoded.errors[1], base64::decode_error::invalid_size);
+  ASSERT_EQ(urlDecoded[2], "fo");
+}
+
 int main(int argc, char** argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
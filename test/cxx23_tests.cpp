@@ -0,0 +1,30 @@
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <string>
+
+#include "../include/base64.hpp"
+
+// The std::basic_string buffers are written with resize_and_overwrite() in
+// C++23, which the other tests, built as C++17, do not cover.
+
+// NOLINTNEXTLINE
+TEST(Base64Cxx23Tests, UsesResizeAndOverwrite) {
+#if !defined(__cpp_lib_string_resize_and_overwrite)
+  GTEST_SKIP() << "resize_and_overwrite is not available";
+#endif
+  ASSERT_EQ(base64::to_base64(std::string("foobar")), "Zm9vYmFy");
+  ASSERT_EQ(base64::from_base64(std::string("Zm9vYmFy")), "foobar");
+  ASSERT_EQ(base64::decode_into<std::string>("Zm9vYg=="), "foob");
+}
+
+// NOLINTNEXTLINE
+TEST(Base64Cxx23Tests, RethrowsDecodeErrors) {
+  ASSERT_THROW(base64::decode_into<std::string>("Zm9v*mFy"),
+               std::runtime_error);
+  ASSERT_THROW(base64::decode_into<std::string>("Zm9vYmF*"),
+               std::runtime_error);
+
+  std::string decoded = base64::decode_into<std::string>("Zm9vYmFy");
+  ASSERT_EQ(decoded, "foobar");
+}
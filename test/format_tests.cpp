@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#if defined(BASE64_TEST_FMT)
+#include <fmt/format.h>
+#endif
+
+#include "../include/base64_format.hpp"
+#include "test_bytes.hpp"
+
+#if defined(__cpp_lib_format)
+// NOLINTNEXTLINE
+TEST(Base64FormatTests, StdFormat) {
+  std::string const data = "Many hands make light work.";
+  ASSERT_EQ(std::format("key={}", base64::as_base64(data)),
+            "key=" + base64::to_base64(data));
+  ASSERT_EQ(std::format("{:un}", base64::as_base64("\xFB\xFF")), "-_8");
+  ASSERT_EQ(std::format("{:.8}", base64::as_base64(data)), "TWFueSBo...");
+  base64::format_view const view = base64::as_base64(data);
+  ASSERT_THROW((void)std::vformat("{:x}", std::make_format_args(view)),
+               std::format_error);
+}
+#endif
+
+#if defined(BASE64_TEST_FMT)
+// NOLINTNEXTLINE
+TEST(Base64FormatTests, FmtFormat) {
+  std::string const data = make_test_bytes(2000);
+  ASSERT_EQ(fmt::format("key={}", base64::as_base64(data)),
+            "key=" + base64::to_base64(data));
+  ASSERT_EQ(fmt::format("{:u}", base64::as_base64(data)),
+            base64::to_base64url(data));
+
+  std::string unpadded = base64::to_base64url(data.substr(0, 1999));
+  unpadded.erase(unpadded.find('='));
+  ASSERT_EQ(fmt::format("{:nu}", base64::as_base64(data.substr(0, 1999))),
+            unpadded);
+
+  ASSERT_EQ(fmt::format("{:.1500}", base64::as_base64(data)),
+            base64::to_base64(data).substr(0, 1500) + "...");
+  ASSERT_EQ(fmt::format("{:.0}", base64::as_base64(data)), "...");
+  ASSERT_EQ(fmt::format("{:.4}", base64::as_base64("foo")), "Zm9v");
+  ASSERT_EQ(fmt::format("[{}]", base64::as_base64("")), "[]");
+  ASSERT_THROW((void)fmt::format(fmt::runtime("{:x}"), base64::as_base64("")),
+               fmt::format_error);
+  ASSERT_THROW((void)fmt::format(fmt::runtime("{:.}"), base64::as_base64("")),
+               fmt::format_error);
+}
+
+// NOLINTNEXTLINE
+TEST(Base64FormatTests, AcceptsByteContainers) {
+  std::vector<std::uint8_t> const bytes = {0x00, 0x01, 0xFE, 0xFF};
+  ASSERT_EQ(fmt::format("{}", base64::as_base64(bytes)), "AAH+/w==");
+  std::array<std::byte, 2> const array = {std::byte{0x66}, std::byte{0x6F}};
+  ASSERT_EQ(fmt::format("{:n}", base64::as_base64(array)), "Zm8");
+  std::string buffer;
+  fmt::format_to(std::back_inserter(buffer), "id={}", base64::as_base64(bytes));
+  ASSERT_EQ(buffer, "id=AAH+/w==");
+}
+#endif
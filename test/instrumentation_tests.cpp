@@ -0,0 +1,169 @@
+#define BASE64_ENABLE_INSTRUMENTATION
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "../include/base16.hpp"
+#include "../include/base32.hpp"
+#include "../include/base64.hpp"
+#include "../include/base64_batch.hpp"
+#include "../include/base64_stream.hpp"
+
+namespace {
+
+std::vector<std::uint64_t> latencies;
+
+void record_latency(base64::operation, std::size_t, std::uint64_t ns) {
+  latencies.push_back(ns);
+}
+
+std::size_t index(base64::operation op) { return static_cast<std::size_t>(op); }
+
+std::size_t index(base64::decode_error error) {
+  return static_cast<std::size_t>(error);
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(Base64Instrumentation, CountsCallsAndBytes) {
+  auto& counters = base64::instrumentation::thread_counters();
+  counters = {};
+
+  base64::to_base64("Hello");
+  base64::encode_into<std::vector<std::uint8_t>>(std::string(30, 'x'));
+  base64::from_base64("SGVsbG8=");
+
+  auto const encode = index(base64::operation::encode);
+  auto const decode = index(base64::operation::decode);
+  ASSERT_EQ(counters.calls[encode], 2);
+  ASSERT_EQ(counters.bytes_in[encode], 35);
+  ASSERT_EQ(counters.bytes_out[encode], 48);
+  ASSERT_EQ(counters.calls[decode], 1);
+  ASSERT_EQ(counters.bytes_in[decode], 8);
+  ASSERT_EQ(counters.bytes_out[decode], 5);
+  ASSERT_EQ(counters.kernels[static_cast<std::size_t>(base64::kernel::scalar)],
+            3);
+}
+
+// NOLINTNEXTLINE
+TEST(Base64Instrumentation, CountsNonTemporalKernel) {
+  auto& counters = base64::instrumentation::thread_counters();
+  counters = {};
+  std::size_t const threshold = base64::non_temporal_threshold();
+  base64::set_non_temporal_threshold(64);
+
+  std::string const encoded = base64::to_base64(std::string(3000, 'x'));
+  base64::from_base64(encoded);
+  base64::to_base64("Hello");
+  base64::set_non_temporal_threshold(threshold);
+
+  auto const& kernels = counters.kernels;
+#if defined(BASE64_HAS_NON_TEMPORAL_STORES)
+  ASSERT_EQ(kernels[static_cast<std::size_t>(
+                base64::kernel::scalar_non_temporal)],
+            2);
+  ASSERT_EQ(kernels[static_cast<std::size_t>(base64::kernel::scalar)], 1);
+#else
+  ASSERT_EQ(kernels[static_cast<std::size_t>(base64::kernel::scalar)], 3);
+#endif
+}
+
+// NOLINTNEXTLINE
+TEST(Base64Instrumentation, CountsErrorsByCategory) {
+  auto& counters = base64::instrumentation::thread_counters();
+  counters = {};
+
+  ASSERT_THROW(base64::from_base64("AAA"), std::runtime_error);
+  ASSERT_THROW(base64::from_base64("A==="), std::runtime_error);
+  ASSERT_THROW(base64::from_base64("AA~A"), std::runtime_error);
+  ASSERT_THROW(base64::from_base64("AA~A"), std::runtime_error);
+
+  ASSERT_EQ(counters.calls[index(base64::operation::decode)], 4);
+  ASSERT_EQ(counters.errors[index(base64::decode_error::invalid_size)], 1);
+  ASSERT_EQ(counters.errors[index(base64::decode_error::invalid_padding)], 1);
+  ASSERT_EQ(counters.errors[index(base64::decode_error::invalid_character)],
+            2);
+  ASSERT_EQ(counters.bytes_out[index(base64::operation::decode)], 0);
+}
+
+// NOLINTNEXTLINE
+TEST(Base64Instrumentation, CountsBase32AndBase16) {
+  auto& counters = base64::instrumentation::thread_counters();
+  counters = {};
+
+  ASSERT_EQ(base32::to_base32("Hello"), "JBSWY3DP");
+  ASSERT_EQ(base16::from_base16("48656C6C6F"), "Hello");
+  ASSERT_THROW(base32::from_base32("JBS"), std::runtime_error);
+  ASSERT_THROW(base32::from_base32("JBSWY3D1"), std::runtime_error);
+  ASSERT_THROW(base16::from_base16("486"), std::runtime_error);
+  ASSERT_THROW(base16::from_base16("48XX"), std::runtime_error);
+
+  ASSERT_EQ(counters.calls[index(base64::operation::encode)], 1);
+  ASSERT_EQ(counters.bytes_in[index(base64::operation::encode)], 5);
+  ASSERT_EQ(counters.bytes_out[index(base64::operation::encode)], 8);
+  ASSERT_EQ(counters.calls[index(base64::operation::decode)], 5);
+  ASSERT_EQ(counters.bytes_out[index(base64::operation::decode)], 5);
+  ASSERT_EQ(counters.errors[index(base64::decode_error::invalid_size)], 2);
+  ASSERT_EQ(counters.errors[index(base64::decode_error::invalid_character)],
+            2);
+}
+
+// NOLINTNEXTLINE
+TEST(Base64Instrumentation, CountsBatchErrorsPerMessage) {
+  auto& counters = base64::instrumentation::thread_counters();
+  counters = {};
+
+  std::vector<std::string_view> const texts = {"AAA", "A===", "AA~A", "AAAA",
+                                               "AA~A"};
+  auto const decoded = base64::decode_batch(texts);
+
+  ASSERT_EQ(counters.calls[index(base64::operation::decode)], 1);
+  ASSERT_EQ(counters.errors[index(base64::decode_error::invalid_size)], 1);
+  ASSERT_EQ(counters.errors[index(base64::decode_error::invalid_padding)], 1);
+  ASSERT_EQ(counters.errors[index(base64::decode_error::invalid_character)],
+            2);
+}
+
+// NOLINTNEXTLINE
+TEST(Base64Instrumentation, CountsStreamErrors) {
+  auto& counters = base64::instrumentation::thread_counters();
+  counters = {};
+
+  // The invalid character is decoded before the end of the input is known.
+  std::stringbuf source("Zm9v*mFy" + std::string(64, 'A'));
+  base64::decoding_streambuf decoder(&source, 16);
+  ASSERT_THROW(decoder.sgetc(), std::runtime_error);
+  ASSERT_EQ(counters.errors[index(base64::decode_error::invalid_character)],
+            1);
+}
+
+// NOLINTNEXTLINE
+TEST(Base64Instrumentation, CountersArePerThread) {
+  base64::instrumentation::thread_counters() = {};
+  std::thread([] { base64::to_base64("Hello"); }).join();
+  ASSERT_EQ(base64::instrumentation::thread_counters()
+                .calls[index(base64::operation::encode)],
+            0);
+}
+
+// NOLINTNEXTLINE
+TEST(Base64Instrumentation, ReportsLatency) {
+  latencies.clear();
+  base64::instrumentation::set_latency_hook(record_latency);
+  base64::to_base64(std::string(1000, 'x'));
+  base64::from_base64("SGVsbG8=");
+  base64::instrumentation::set_latency_hook(nullptr);
+  base64::to_base64("Hello");
+  ASSERT_EQ(latencies.size(), 2);
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
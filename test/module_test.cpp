@@ -0,0 +1,8 @@
+// Checks that the library can be used through its C++20 module interface.
+import base64;
+
+int main() {
+  return base64::from_base64(base64::to_base64("Hello")).compare("Hello") == 0
+             ? 0
+             : 1;
+}
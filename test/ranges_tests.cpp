@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <list>
+#include <ranges>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../include/base64_ranges.hpp"
+#include "test_bytes.hpp"
+
+namespace {
+
+template <class R>
+std::string collect(R&& r) {
+  std::string result;
+  std::ranges::copy(std::forward<R>(r), std::back_inserter(result));
+  return result;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(Base64RangesTests, EncodesLazily) {
+  std::string const data = make_test_bytes(10000);
+  for (std::size_t size : {0, 1, 2, 3, 3071, 3072, 3073, 10000}) {
+    std::string_view const input(data.data(), size);
+    ASSERT_EQ(collect(input | base64::views::encode),
+              base64::to_base64(input));
+    ASSERT_EQ(collect(base64::views::encode_url(input)),
+              base64::to_base64url(input));
+    std::list<std::byte> bytes;
+    for (char c : input) {
+      bytes.push_back(static_cast<std::byte>(c));
+    }
+    ASSERT_EQ(collect(bytes | base64::views::encode),
+              base64::to_base64(input));
+  }
+
+  auto const view = std::string_view("Hello") | base64::views::encode;
+  ASSERT_EQ(view.size(), 8);
+}
+
+// NOLINTNEXTLINE
+TEST(Base64RangesTests, DecodesLazily) {
+  std::string const data = make_test_bytes(10000);
+  for (std::size_t size : {0, 1, 2, 3, 3071, 3072, 3073, 10000}) {
+    std::string const encoded =
+        base64::to_base64(std::string_view(data.data(), size));
+    ASSERT_EQ(collect(encoded | base64::views::decode), data.substr(0, size));
+    std::list<char> const chars(encoded.begin(), encoded.end());
+    ASSERT_EQ(collect(chars | base64::views::decode), data.substr(0, size));
+  }
+
+  std::string url = base64::to_base64url(data.substr(0, 5000));
+  url.erase(url.find('='));
+  ASSERT_EQ(collect(url | base64::views::decode_url), data.substr(0, 5000));
+}
+
+// NOLINTNEXTLINE
+TEST(Base64RangesTests, ComposesWithStandardViews) {
+  std::string const data = make_test_bytes(100000);
+  std::string encoded = base64::to_base64(data);
+
+  // Only the first block is decoded, so the invalid tail is never reached.
+  encoded[encoded.size() - 10] = '*';
+  ASSERT_EQ(collect(encoded | base64::views::decode | std::views::take(16)),
+            data.substr(0, 16));
+
+  std::istringstream stream(base64::to_base64(std::string_view("Hello")));
+  auto decoded = std::views::istream<char>(stream) | base64::views::decode;
+  ASSERT_EQ(collect(decoded), "Hello");
+
+  auto letters = std::string_view("Hello, World!") | base64::views::encode |
+                 std::views::filter([](char c) { return c != 'G'; });
+  ASSERT_EQ(collect(letters), "SVsb8sIFdvcmxkIQ==");
+}
+
+// NOLINTNEXTLINE
+TEST(Base64RangesTests, RejectsInvalidInput) {
+  std::string encoded = base64::to_base64(make_test_bytes(10000));
+  encoded[encoded.size() - 10] = '*';
+  ASSERT_THROW(collect(encoded | base64::views::decode), std::runtime_error);
+  encoded[encoded.size() - 10] = 'A';
+  encoded[100] = '=';
+  ASSERT_THROW(collect(encoded | base64::views::decode), std::runtime_error);
+  ASSERT_THROW(collect(std::string_view("SGVsbG8") | base64::views::decode),
+               std::runtime_error);
+}
@@ -0,0 +1,29 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../include/base64_decl.hpp"
+
+#if defined(BASE64_HPP_)
+#error "The declarations-only header must not pull in the implementation"
+#endif
+
+// NOLINTNEXTLINE
+TEST(Base64StaticLibraryTests, UsesCompiledInstantiations) {
+  ASSERT_EQ(base64::to_base64("Hello, World!"), "SGVsbG8sIFdvcmxkIQ==");
+  ASSERT_EQ(base64::from_base64("SGVsbG8sIFdvcmxkIQ=="), "Hello, World!");
+  ASSERT_EQ(base64::to_base64url("\xFB\xFF"), "-_8=");
+  ASSERT_EQ(base64::from_base64url("-_8"), "\xFB\xFF");
+
+  auto const bytes = base64::decode_into<std::vector<std::byte>>("AQI=");
+  ASSERT_EQ(bytes, (std::vector<std::byte>{std::byte{1}, std::byte{2}}));
+  auto const url = base64::encode_into<std::vector<std::uint8_t>,
+                                       base64::alphabet::url>("\xFB\xFF");
+  ASSERT_EQ(std::string(url.begin(), url.end()), "-_8=");
+
+  ASSERT_THROW(base64::from_base64("SGVsbG8"), std::runtime_error);
+}
@@ -0,0 +1,17 @@
+#ifndef BASE64_TEST_BYTES_HPP_
+#define BASE64_TEST_BYTES_HPP_
+
+#include <cstddef>
+#include <string>
+
+// Returns `size` bytes that cover all byte values and have no period
+// shorter than 256, as input for the tests and benchmarks.
+inline std::string make_test_bytes(std::size_t size) {
+  std::string bytes(size, '\0');
+  for (std::size_t i = 0; i < size; ++i) {
+    bytes[i] = static_cast<char>(i * 37 + 11);
+  }
+  return bytes;
+}
+
+#endif  // BASE64_TEST_BYTES_HPP_
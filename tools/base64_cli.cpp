@@ -0,0 +1,634 @@
+// Command-line base64 encoder and decoder built on base64.hpp. Mostly
+// compatible with the coreutils `base64` tool, and doubles as an end-to-end
+// benchmark of the library against it.
+#include <fcntl.h>
+#include <getopt.h>
+#include <limits.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "../include/base64.hpp"
+
+namespace {
+
+// Amount of binary input encoded, and of text input decoded, per thread and
+// batch.
+constexpr size_t encode_block_size = size_t{3} << 20;
+constexpr size_t decode_block_size = size_t{4} << 20;
+
+struct options {
+  bool decode = false;
+  bool ignore_garbage = false;
+  base64::alphabet alphabet = base64::alphabet::standard;
+  size_t wrap = 76;
+  unsigned threads = 1;
+  const char* path = nullptr;
+};
+
+[[noreturn]] void fail_errno(const char* what) {
+  std::fprintf(stderr, "base64: %s: %s\n", what, std::strerror(errno));
+  std::exit(EXIT_FAILURE);
+}
+
+// Threads started once and reused for every block of input.
+class worker_pool {
+ public:
+  explicit worker_pool(unsigned threads) : errors_(threads) {
+    for (unsigned i = 1; i < threads; ++i) {
+      workers_.emplace_back([this, i] { work(i); });
+    }
+  }
+
+  worker_pool(const worker_pool&) = delete;
+  worker_pool& operator=(const worker_pool&) = delete;
+
+  ~worker_pool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    start_.notify_all();
+    for (auto& worker : workers_) {
+      worker.join();
+    }
+  }
+
+  // Runs fn(0) ... fn(n - 1) concurrently, where n is the number of threads,
+  // and rethrows the first exception.
+  void run(const std::function<void(unsigned)>& fn) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      job_ = &fn;
+      running_ = static_cast<unsigned>(workers_.size());
+      ++generation_;
+    }
+    start_.notify_all();
+    call(0);
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      done_.wait(lock, [this] { return running_ == 0; });
+    }
+    for (auto& error : errors_) {
+      if (error) {
+        std::rethrow_exception(std::exchange(error, nullptr));
+      }
+    }
+  }
+
+ private:
+  void call(unsigned i) {
+    try {
+      (*job_)(i);
+    } catch (...) {
+      errors_[i] = std::current_exception();
+    }
+  }
+
+  void work(unsigned i) {
+    uint64_t generation = 0;
+    for (;;) {
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        start_.wait(lock,
+                    [&] { return stop_ || generation_ != generation; });
+        if (stop_) {
+          return;
+        }
+        generation = generation_;
+      }
+      call(i);
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--running_ != 0) {
+          continue;
+        }
+      }
+      done_.notify_one();
+    }
+  }
+
+  std::mutex mutex_;
+  std::condition_variable start_;
+  std::condition_variable done_;
+  const std::function<void(unsigned)>* job_ = nullptr;
+  uint64_t generation_ = 0;
+  unsigned running_ = 0;
+  bool stop_ = false;
+  std::vector<std::exception_ptr> errors_;
+  std::vector<std::thread> workers_;
+};
+
+// Provides the input in blocks, either from a memory mapping of a regular
+// file or by reading a file descriptor in large chunks.
+class input_source {
+ public:
+  explicit input_source(const char* path) {
+    if (path != nullptr && std::strcmp(path, "-") != 0) {
+      fd_ = ::open(path, O_RDONLY);
+      if (fd_ < 0) {
+        fail_errno(path);
+      }
+    }
+    struct stat st;
+    if (::fstat(fd_, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+      void* map = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ,
+                         MAP_PRIVATE, fd_, 0);
+      if (map != MAP_FAILED) {
+        ::posix_madvise(map, static_cast<size_t>(st.st_size),
+                        POSIX_MADV_SEQUENTIAL);
+        map_ = static_cast<const char*>(map);
+        map_size_ = static_cast<size_t>(st.st_size);
+      }
+    }
+  }
+
+  input_source(const input_source&) = delete;
+  input_source& operator=(const input_source&) = delete;
+
+  ~input_source() {
+    if (map_ != nullptr) {
+      ::munmap(const_cast<char*>(map_), map_size_);
+    }
+    if (fd_ != STDIN_FILENO) {
+      ::close(fd_);
+    }
+  }
+
+  // Returns the next `size` bytes of input, or fewer at the end of the input.
+  std::string_view next(size_t size) {
+    if (map_ != nullptr) {
+      const size_t count = std::min(size, map_size_ - offset_);
+      std::string_view block(map_ + offset_, count);
+      offset_ += count;
+      return block;
+    }
+    buffer_.resize(size);
+    size_t count = 0;
+    while (count < size) {
+      const ssize_t result = ::read(fd_, &buffer_[count], size - count);
+      if (result == 0) {
+        break;
+      }
+      if (result < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        fail_errno("read error");
+      }
+      count += static_cast<size_t>(result);
+    }
+    return std::string_view(buffer_.data(), count);
+  }
+
+ private:
+  int fd_ = STDIN_FILENO;
+  const char* map_ = nullptr;
+  size_t map_size_ = 0;
+  size_t offset_ = 0;
+  std::string buffer_;
+};
+
+// Collects output blocks and writes them with as few writev() calls as
+// possible.
+class output_writer {
+ public:
+  void add(const char* data, size_t size) {
+    if (size != 0) {
+      iov_.push_back({const_cast<char*>(data), size});
+    }
+  }
+
+  void flush() {
+    size_t first = 0;
+    while (first < iov_.size()) {
+      const int count =
+          static_cast<int>(std::min<size_t>(iov_.size() - first, IOV_MAX));
+      const ssize_t result = ::writev(STDOUT_FILENO, &iov_[first], count);
+      if (result < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        fail_errno("write error");
+      }
+      size_t written = static_cast<size_t>(result);
+      while (first < iov_.size() && written >= iov_[first].iov_len) {
+        written -= iov_[first].iov_len;
+        ++first;
+      }
+      if (written != 0) {
+        iov_[first].iov_base =
+            static_cast<char*>(iov_[first].iov_base) + written;
+        iov_[first].iov_len -= written;
+      }
+    }
+    iov_.clear();
+  }
+
+ private:
+  std::vector<iovec> iov_;
+};
+
+// Copies `encoded` to `out`, inserting a newline whenever `column` reaches
+// `wrap`.
+void wrap_into(std::string_view encoded, size_t column, size_t wrap,
+               std::string& out) {
+  out.clear();
+  out.reserve(encoded.size() + encoded.size() / wrap + 1);
+  while (!encoded.empty()) {
+    const size_t count = std::min(wrap - column, encoded.size());
+    out.append(encoded.data(), count);
+    encoded.remove_prefix(count);
+    column += count;
+    if (column == wrap) {
+      out.push_back('\n');
+      column = 0;
+    }
+  }
+}
+
+template <base64::alphabet A>
+void encode_stream(input_source& input, const options& opts) {
+  worker_pool pool(opts.threads);
+  output_writer writer;
+  std::vector<std::string> encoded(opts.threads);
+  std::vector<std::string> wrapped(opts.threads);
+  size_t column = 0;
+
+  for (;;) {
+    const std::string_view block =
+        input.next(encode_block_size * opts.threads);
+    if (block.empty()) {
+      break;
+    }
+    const size_t slice =
+        ((block.size() + opts.threads - 1) / opts.threads + 2) / 3 * 3;
+    pool.run([&](unsigned i) {
+      const size_t begin = std::min(block.size(), slice * i);
+      const size_t end = std::min(block.size(), begin + slice);
+      encoded[i] = base64::encode_into<std::string, A>(block.data() + begin,
+                                                       block.data() + end);
+      if (opts.wrap != 0) {
+        const size_t first = column + begin / 3 * 4;
+        wrap_into(encoded[i], first % opts.wrap, opts.wrap, wrapped[i]);
+      }
+    });
+    for (unsigned i = 0; i < opts.threads; ++i) {
+      const std::string& out = opts.wrap != 0 ? wrapped[i] : encoded[i];
+      writer.add(out.data(), out.size());
+    }
+    writer.flush();
+    if (opts.wrap != 0) {
+      column = (column + base64::encoded_size(block.size())) % opts.wrap;
+    }
+  }
+
+  if (column != 0) {
+    writer.add("\n", 1);
+    writer.flush();
+  }
+}
+
+// Returns the characters to keep while decoding: the alphabet and padding.
+constexpr std::array<bool, 256> make_keep_table(base64::alphabet alphabet) {
+  std::array<bool, 256> keep{};
+  for (unsigned c = 'A'; c <= 'Z'; ++c) {
+    keep[c] = true;
+  }
+  for (unsigned c = 'a'; c <= 'z'; ++c) {
+    keep[c] = true;
+  }
+  for (unsigned c = '0'; c <= '9'; ++c) {
+    keep[c] = true;
+  }
+  const bool url = alphabet == base64::alphabet::url;
+  keep[static_cast<uint8_t>(url ? '-' : '+')] = true;
+  keep[static_cast<uint8_t>(url ? '_' : '/')] = true;
+  keep[static_cast<uint8_t>('=')] = true;
+  return keep;
+}
+
+// Characters of a group that is split by a newline or by the end of a block.
+struct group_carry {
+  char chars[4];
+  size_t size = 0;
+};
+
+// Decodes one part of a block of input. The kept characters, the alphabet and
+// padding, are decoded straight from the input, a line at a time; only the
+// characters of a group that spans lines are copied, into `carry`.
+template <base64::alphabet A>
+class slice_decoder {
+ public:
+  static constexpr std::array<bool, 256> keep = make_keep_table(A);
+
+  // Starts a new block, continuing the group in `carry` after skipping
+  // `skip` kept characters that belong to the previous slice's last group.
+  // `garbage` tells whether the slice holds characters other than the kept
+  // ones and newlines.
+  void reset(const group_carry& carry, size_t skip, bool garbage) {
+    out.clear();
+    carry_ = carry;
+    skip_ = skip;
+    garbage_ = garbage;
+    decoded = false;
+    padded = false;
+  }
+
+  // Decodes the groups that start in [begin, end). The last of them may
+  // continue up to `limit`; what it lacks after that is left in carry().
+  void decode(const char* begin, const char* end, const char* limit) {
+    out.reserve(static_cast<size_t>(end - begin) / 4 * 3 + 3);
+    while (begin != end) {
+      const char* run = begin;
+      if (garbage_) {
+        if (!keep[static_cast<uint8_t>(*begin)]) {
+          ++begin;
+          continue;
+        }
+        while (begin != end && keep[static_cast<uint8_t>(*begin)]) {
+          ++begin;
+        }
+      } else {
+        const void* newline =
+            std::memchr(begin, '\n', static_cast<size_t>(end - begin));
+        begin = newline != nullptr ? static_cast<const char*>(newline) : end;
+      }
+      if (begin != run) {
+        add_run(run, begin);
+      }
+      if (begin != end && !garbage_) {
+        ++begin;
+      }
+    }
+    while (carry_.size != 0 && begin != limit) {
+      if (keep[static_cast<uint8_t>(*begin)]) {
+        add_run(begin, begin + 1);
+      }
+      ++begin;
+    }
+  }
+
+  // Decodes the group left at the end of the input, which may be unpadded.
+  void finish() {
+    if (carry_.size != 0) {
+      decode_chunk(std::string_view(carry_.chars, carry_.size));
+      carry_.size = 0;
+    }
+  }
+
+  const group_carry& carry() const { return carry_; }
+
+  std::string out;
+  // Whether any group was decoded, and whether the last one was padded.
+  bool decoded = false;
+  bool padded = false;
+
+ private:
+  void add_run(const char* begin, const char* end) {
+    const size_t skipped =
+        std::min(skip_, static_cast<size_t>(end - begin));
+    begin += skipped;
+    skip_ -= skipped;
+    if (carry_.size != 0) {
+      const size_t count =
+          std::min(4 - carry_.size, static_cast<size_t>(end - begin));
+      std::memcpy(carry_.chars + carry_.size, begin, count);
+      carry_.size += count;
+      begin += count;
+      if (carry_.size < 4) {
+        return;
+      }
+      decode_chunk(std::string_view(carry_.chars, 4));
+      carry_.size = 0;
+    }
+    const size_t whole = static_cast<size_t>(end - begin) & ~size_t{3};
+    if (whole != 0) {
+      decode_chunk(std::string_view(begin, whole));
+      begin += whole;
+    }
+    carry_.size = static_cast<size_t>(end - begin);
+    std::memcpy(carry_.chars, begin, carry_.size);
+  }
+
+  // Only the last group of the input may be padded.
+  void decode_chunk(std::string_view chunk) {
+    if (padded) {
+      throw std::runtime_error{"invalid input"};
+    }
+    base64::append_decoded<A>(out, chunk);
+    decoded = true;
+    padded = chunk.back() == '=';
+  }
+
+  group_carry carry_;
+  size_t skip_ = 0;
+  bool garbage_ = false;
+};
+
+template <base64::alphabet A>
+void decode_stream(input_source& input, const options& opts) {
+  worker_pool pool(opts.threads);
+  output_writer writer;
+  std::vector<slice_decoder<A>> slices(opts.threads);
+  std::vector<size_t> kept(opts.threads);
+  std::vector<char> garbage(opts.threads);
+  group_carry carry;
+  bool padded = false;
+
+  for (;;) {
+    const std::string_view block =
+        input.next(decode_block_size * opts.threads);
+    if (block.empty()) {
+      break;
+    }
+    const size_t slice = (block.size() + opts.threads - 1) / opts.threads;
+    auto bounds = [&](unsigned i) {
+      const size_t begin = std::min(block.size(), slice * i);
+      return std::make_pair(block.data() + begin,
+                            block.data() + std::min(block.size(),
+                                                    begin + slice));
+    };
+
+    // Counts the kept characters of every slice to find where its first
+    // group starts. Newlines, and with --ignore-garbage anything else outside
+    // the alphabet, are skipped.
+    pool.run([&](unsigned i) {
+      const auto [begin, end] = bounds(i);
+      size_t count = 0;
+      bool invalid = false;
+      for (const char* c = begin; c != end; ++c) {
+        const bool valid = slice_decoder<A>::keep[static_cast<uint8_t>(*c)];
+        invalid |= !valid && *c != '\n';
+        count += valid;
+      }
+      if (invalid && !opts.ignore_garbage) {
+        throw std::runtime_error{"invalid input"};
+      }
+      kept[i] = count;
+      garbage[i] = invalid;
+    });
+    slices[0].reset(carry, 0, garbage[0]);
+    size_t position = carry.size + kept[0];
+    for (unsigned i = 1; i < opts.threads; ++i) {
+      slices[i].reset(group_carry{}, (4 - position % 4) % 4, garbage[i]);
+      position += kept[i];
+    }
+
+    pool.run([&](unsigned i) {
+      const auto [begin, end] = bounds(i);
+      slices[i].decode(begin, end, block.data() + block.size());
+    });
+    carry = {};
+    for (auto& decoder : slices) {
+      if (decoder.decoded) {
+        if (padded) {
+          throw std::runtime_error{"invalid input"};
+        }
+        padded = decoder.padded;
+      }
+      if (decoder.carry().size != 0) {
+        carry = decoder.carry();
+      }
+      writer.add(decoder.out.data(), decoder.out.size());
+    }
+    writer.flush();
+  }
+
+  if (carry.size != 0) {
+    if (padded) {
+      throw std::runtime_error{"invalid input"};
+    }
+    slices[0].reset(carry, 0, false);
+    slices[0].finish();
+    writer.add(slices[0].out.data(), slices[0].out.size());
+    writer.flush();
+  }
+}
+
+[[noreturn]] void usage(int status) {
+  std::fprintf(status == EXIT_SUCCESS ? stdout : stderr,
+               "Usage: base64 [OPTION]... [FILE]\n"
+               "Base64 encode or decode FILE, or standard input, to standard "
+               "output.\n\n"
+               "  -d, --decode          decode data\n"
+               "  -i, --ignore-garbage  when decoding, ignore non-alphabet "
+               "characters\n"
+               "  -w, --wrap=COLS       wrap encoded lines after COLS "
+               "characters (default 76).\n"
+               "                        Use 0 to disable line wrapping\n"
+               "      --url             use the URL and filename safe "
+               "alphabet (RFC 4648)\n"
+               "  -t, --threads=N       use N threads (default 1)\n"
+               "  -h, --help            display this help and exit\n");
+  std::exit(status);
+}
+
+options parse_options(int argc, char* argv[]) {
+  enum { url_option = 256 };
+  static const struct option long_options[] = {
+      {"decode", no_argument, nullptr, 'd'},
+      {"ignore-garbage", no_argument, nullptr, 'i'},
+      {"wrap", required_argument, nullptr, 'w'},
+      {"url", no_argument, nullptr, url_option},
+      {"threads", required_argument, nullptr, 't'},
+      {"help", no_argument, nullptr, 'h'},
+      {nullptr, 0, nullptr, 0}};
+
+  options opts;
+  int c;
+  while ((c = ::getopt_long(argc, argv, "diw:t:h", long_options, nullptr)) !=
+         -1) {
+    switch (c) {
+      case 'd': {
+        opts.decode = true;
+        break;
+      }
+      case 'i': {
+        opts.ignore_garbage = true;
+        break;
+      }
+      case 'w': {
+        // strtoul() would accept a sign and leading spaces, and wrap "-5".
+        char* end = nullptr;
+        errno = 0;
+        opts.wrap = std::strtoul(optarg, &end, 10);
+        if (*optarg < '0' || *optarg > '9' || *end != '\0' ||
+            errno == ERANGE) {
+          std::fprintf(stderr, "base64: invalid wrap size: '%s'\n", optarg);
+          usage(EXIT_FAILURE);
+        }
+        break;
+      }
+      case url_option: {
+        opts.alphabet = base64::alphabet::url;
+        break;
+      }
+      case 't': {
+        const long threads = std::strtol(optarg, nullptr, 10);
+        if (threads < 1 || threads > 1024) {
+          std::fprintf(stderr, "base64: invalid number of threads: '%s'\n",
+                       optarg);
+          usage(EXIT_FAILURE);
+        }
+        opts.threads = static_cast<unsigned>(threads);
+        break;
+      }
+      case 'h': {
+        usage(EXIT_SUCCESS);
+      }
+      default: {
+        usage(EXIT_FAILURE);
+      }
+    }
+  }
+
+  if (argc - optind > 1) {
+    std::fprintf(stderr, "base64: extra operand '%s'\n", argv[optind + 1]);
+    usage(EXIT_FAILURE);
+  }
+  if (optind < argc) {
+    opts.path = argv[optind];
+  }
+  return opts;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  const options opts = parse_options(argc, argv);
+  input_source input(opts.path);
+  try {
+    const bool url = opts.alphabet == base64::alphabet::url;
+    if (opts.decode) {
+      url ? decode_stream<base64::alphabet::url>(input, opts)
+          : decode_stream<base64::alphabet::standard>(input, opts);
+    } else {
+      url ? encode_stream<base64::alphabet::url>(input, opts)
+          : encode_stream<base64::alphabet::standard>(input, opts);
+    }
+  } catch (const std::exception&) {
+    std::fprintf(stderr, "base64: invalid input\n");
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}